@@ -10,10 +10,37 @@ TARGET = SotkuMuija
 
 CONFIG += sailfishapp
 
+QT += network dbus
+
 SOURCES += src/SotkuMuija.cpp \
     src/qfoodcalendar.cpp \
+    src/qmenusearch.cpp \
+    src/qmenuhistory.cpp \
+    src/menupageloader.cpp \
+    src/menuparser.cpp \
+    src/menuparseworker.cpp \
+    src/menucache.cpp \
+    src/menusnapshot.cpp \
+    src/menuarchive.cpp \
+    src/dishpool.cpp \
+    src/dishindex.cpp \
+    src/mealschedule.cpp \
+    src/mealindex.cpp \
+    src/mealconfig.cpp \
+    src/reminderengine.cpp \
+    src/remindersink.cpp \
     src/qtimespan.cpp \
-    src/tjcalculatorbackend.cpp
+    src/qtimespanvalue.cpp \
+    src/tjcalculatorbackend.cpp \
+    src/tjcalculatorworker.cpp \
+    src/roster.cpp \
+    src/rosterimporter.cpp \
+    src/pluralformatter.cpp \
+    src/orderstatistictree.cpp \
+    src/rosterleaderboard.cpp \
+    src/kioskserver.cpp \
+    src/wakeupscheduler.cpp \
+    src/visibilitytracker.cpp
 
 OTHER_FILES += qml/SotkuMuija.qml \
     qml/cover/CoverPage.qml \
@@ -23,10 +50,46 @@ OTHER_FILES += qml/SotkuMuija.qml \
     qml/pages/TjPage.qml \
     qml/pages/FoodPage.qml \
     qml/pages/FoodSettings.qml \
-    config.json
+    qml/pages/HistoryPage.qml \
+    config.json \
+    tjd/tjd.pro \
+    tjd/fi.sotkumuija.Tj.service \
+    tests/tests.pro
 
 HEADERS += \
     src/qfoodcalendar.h \
+    src/qmenusearch.h \
+    src/qmenuhistory.h \
+    src/menupageloader.h \
+    src/menuday.h \
+    src/menuparser.h \
+    src/menuparseworker.h \
+    src/menucache.h \
+    src/menusnapshot.h \
+    src/menuarchive.h \
+    src/dishpool.h \
+    src/dishindex.h \
+    src/mealschedule.h \
+    src/mealindex.h \
+    src/mealconfig.h \
+    src/reminderengine.h \
+    src/remindersink.h \
     src/qtimespan.h \
-    src/tjcalculatorbackend.h
+    src/qtimespanvalue.h \
+    src/tjcalculatorbackend.h \
+    src/tjcalculatorworker.h \
+    src/tjsnapshot.h \
+    src/roster.h \
+    src/rosterimporter.h \
+    src/pluralformatter.h \
+    src/orderstatistictree.h \
+    src/rosterleaderboard.h \
+    src/kioskserver.h \
+    src/wakeupscheduler.h \
+    src/visibilitytracker.h
+
+# Default meal times, edits are saved to a copy in the data directory.
+mealconfig.files = config.json
+mealconfig.path = /usr/share/$${TARGET}
 
+INSTALLS += mealconfig
@@ -30,12 +30,19 @@
 
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import SotkuMuija 1.0
 import "pages"
 
 ApplicationWindow
 {
     initialPage: Component { TjPage { } }
     cover: Qt.resolvedUrl("cover/CoverPage.qml")
+
+    Binding {
+        target: Visibility
+        property: "applicationActive"
+        value: Qt.application.active
+    }
 }
 
 
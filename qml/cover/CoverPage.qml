@@ -30,10 +30,20 @@
 
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import SotkuMuija 1.0
 
 CoverBackground {
     id: cover
 
+    onStatusChanged: Backend.setLiveConsumer(cover, status === Cover.Active)
+
+    // kansi näkyy jo esiin liukuessaan
+    Binding {
+        target: Visibility
+        property: "coverActive"
+        value: cover.status !== Cover.Inactive
+    }
+
     Column {
         width: cover.width
         spacing: Theme.paddingSmall
@@ -50,10 +60,18 @@ CoverBackground {
         Label {
             id: days
             anchors.horizontalCenter: parent.horizontalCenter
-            text: backend.tjInDays
+            text: Backend.remaining.morningsText
             color: Theme.primaryColor
         }
 
+        Label {
+            anchors.horizontalCenter: parent.horizontalCenter
+            visible: Backend.live
+            text: Backend.countdown
+            color: Theme.secondaryColor
+            font.pixelSize: Theme.fontSizeSmall
+        }
+
         Separator {
             x: Theme.paddingLarge
             width: parent.width - Theme.paddingLarge * 2
@@ -99,14 +117,15 @@ CoverBackground {
         Label {
             id: foodType
             anchors.horizontalCenter: parent.horizontalCenter
-            text: "Iltapala"
+            // ennen aamupalaa näytetään tuleva ateria
+            text: Menu.currentMeal !== "" ? Menu.currentMeal : Menu.nextMeal
             color: Theme.primaryColor
             font.family: Theme.fontFamilyHeading
         }
         Label {
             id: foodName
             anchors.horizontalCenter: parent.horizontalCenter
-            text: "Paskaa pakista w/ ripuli"
+            text: Menu.currentMeal !== "" ? Menu.currentMealText : Menu.nextMealText
             color: Theme.primaryColor
             wrapMode: Text.Wrap
             width: parent.width - Theme.paddingMedium * 2
@@ -29,47 +29,48 @@
 */
 
 import QtQuick 2.0
-import QtQuick.XmlListModel 2.0
 import Sailfish.Silica 1.0
+import SotkuMuija 1.0
 
 
 Page {
     id: page
 
-    property string dataURL: "https://dl.dropboxusercontent.com/u/22171160/food.xml"
+    property int day: 1
 
-    property string filter: "[@name='1']"
+    // muuttuneet ruoat korostetaan vain kunnes sivulta poistutaan
+    onStatusChanged: {
+        if (status == PageStatus.Deactivating)
+            Menu.markSeen()
+    }
 
     SilicaFlickable {
 
         anchors.fill: parent
 
         PullDownMenu {
+            MenuItem {
+                text: "Historia"
+                onClicked: pageStack.push(Qt.resolvedUrl("HistoryPage.qml"))
+            }
             MenuItem {
                 text: "Asetukset"
                 onClicked: pageStack.push(Qt.resolvedUrl("FoodSettings.qml"))
             }
         }
 
-       XmlListModel {
-            id: foodModel
-            source: page.dataURL
-            query: "/week/day"+filter
-
-            XmlRole {
-                name: "breakfast"
-                query: "breakfast/string()"
-            }
-
-            XmlRole { name: "supper"; query: "supper/string()" }
-            XmlRole { name: "dinner"; query: "dinner/string()" }
-            XmlRole { name: "lunch"; query: "lunch/string()" }
-            XmlRole { name: "name"; query: "@name/string()" }
+       Binding {
+            target: Menu
+            property: "day"
+            value: page.day
+        }
 
+       Connections {
+            target: Menu
             onStatusChanged: {
-                if (status == XmlListModel.Error) {
-                    console.log("ERROR! " + errorString())
-                } else if (status == XmlListModel.Ready) {
+                if (Menu.status == FoodCalendar.Error) {
+                    console.log("ERROR! " + Menu.errorString)
+                } else if (Menu.status == FoodCalendar.Ready) {
                     console.log("JEEE!")
                 }
             }
@@ -85,7 +86,7 @@ Page {
                title: "Leijona vittu"
            }
 
-           model: foodModel
+           model: Menu
 
            // miltä tulis näyttää
            delegate: Item {
@@ -98,7 +99,7 @@ Page {
                     font.bold: false
                     text: model.breakfast
 
-                    color: Theme.secondaryColor
+                    color: model.changed ? Theme.highlightColor : Theme.secondaryColor
                 }
 
                 Label {
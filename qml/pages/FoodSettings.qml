@@ -1,5 +1,6 @@
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import SotkuMuija 1.0
 
 Page {
     id: root
@@ -16,8 +17,29 @@ Page {
             title: "Aika settings vittu"
         }
 
+        // 0 = ei muistutusta, muut configin arvot säilyvät kunnes liukua siirretään
+        footer: Slider {
+            id: reminderSlider
+            width: parent.width
+            minimumValue: 0
+            maximumValue: 60
+            stepSize: 5
+            label: "Muistutus ennen ateriaa"
+            // vedon aikana uusi arvo, muuten configin oma
+            property int minutes: down ? Math.round(value) : MealConfig.reminderMinutes
+            valueText: minutes > 0 ? minutes + " min" : "Ei muistutusta"
+            onReleased: MealConfig.reminderMinutes = value
+
+            Binding {
+                target: reminderSlider
+                property: "value"
+                value: MealConfig.reminderMinutes
+                when: !reminderSlider.down
+            }
+        }
+
         model: ListModel {
-            ListElement { key: "bf"; name: "Aamupala" }
+            ListElement { key: "breakfast"; name: "Aamupala" }
             ListElement { key: "lunch"; name: "Lounas" }
             ListElement { key: "dinner"; name: "Päivällinen" }
             ListElement { key: "supper"; name: "Iltapala" }
@@ -27,13 +49,14 @@ Page {
             width: ListView.view.width
             height: Theme.itemSizeSmall
             onClicked: {
+                var current = MealConfig.times[model.key].split(":")
                 var dialog = pageStack.push("Sailfish.Silica.TimePickerDialog", {
-                    hour: 13,
-                    minute: 30,
+                    hour: parseInt(current[0], 10),
+                    minute: parseInt(current[1], 10),
                     hourMode: DateTime.TwentyFourHours
                 })
                 dialog.accepted.connect(function() {
-                    time.text = dialog.timeText
+                    MealConfig.setMealTime(model.key, dialog.hour, dialog.minute)
                 })
             }
 
@@ -55,7 +78,7 @@ Page {
                 Label {
                     height: parent.height
                     id: time
-                    text: "value"
+                    text: MealConfig.times[model.key]
                     color: Theme.highlightColor
                     font.pixelSize: Theme.fontSizeSmall
                     verticalAlignment: Text.AlignVCenter
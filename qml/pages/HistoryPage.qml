@@ -0,0 +1,86 @@
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+import SotkuMuija 1.0
+
+// koko ruokahistoria päivä kerrallaan, viikot luetaan taustalla
+Page {
+    id: page
+
+    MenuHistory {
+        id: history
+        calendar: Menu
+    }
+
+    SilicaListView {
+        id: historyView
+        anchors.fill: parent
+        orientation: ListView.Horizontal
+        snapMode: ListView.SnapOneItem
+        highlightRangeMode: ListView.StrictlyEnforceRange
+        // lähimmät päivät valmiiksi molemmin puolin
+        cacheBuffer: width
+
+        model: history
+
+        delegate: Item {
+            width: historyView.width
+            height: historyView.height
+
+            Column {
+                width: parent.width
+                spacing: Theme.paddingMedium
+
+                PageHeader {
+                    title: Qt.formatDate(model.date, "ddd d.M.yyyy")
+                }
+
+                BusyIndicator {
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    running: !model.loaded
+                    visible: running
+                }
+
+                Repeater {
+                    model: [
+                        { title: "Aamupala", text: breakfast },
+                        { title: "Lounas", text: lunch },
+                        { title: "Päivällinen", text: dinner },
+                        { title: "Iltapala", text: supper }
+                    ]
+
+                    Column {
+                        x: Theme.paddingLarge
+                        width: parent.width - Theme.paddingLarge * 2
+                        visible: modelData.text !== undefined && modelData.text !== ""
+
+                        Label {
+                            text: modelData.title
+                            color: Theme.highlightColor
+                            font.pixelSize: Theme.fontSizeSmall
+                        }
+                        Label {
+                            width: parent.width
+                            text: modelData.text !== undefined ? modelData.text : ""
+                            color: Theme.primaryColor
+                            wrapMode: Text.Wrap
+                        }
+                    }
+                }
+            }
+        }
+
+        ViewPlaceholder {
+            enabled: historyView.count === 0
+            text: "Ei vielä arkistoituja ruokalistoja"
+        }
+
+        Component.onCompleted: {
+            // tämä päivä, tai viimeisin arkistoitu jos tätä ei vielä ole
+            var row = history.rowOf(new Date())
+            if (row < 0)
+                row = history.count - 1
+            if (row >= 0)
+                positionViewAtIndex(row, ListView.Beginning)
+        }
+    }
+}
@@ -30,17 +30,25 @@
 
 import QtQuick 2.0
 import Sailfish.Silica 1.0
+import SotkuMuija 1.0
 
 
 Page {
     id: page
 
+    // sekuntilaskuri käy vain kun sivu on esillä
+    onStatusChanged: Backend.setLiveConsumer(page, status === PageStatus.Active)
+
     // To enable PullDownMenu, place our content in a SilicaFlickable
     SilicaFlickable {
         anchors.fill: parent
 
         // PullDownMenu and PushUpMenu must be declared in SilicaFlickable, SilicaListView or SilicaGridView
         PullDownMenu {
+            MenuItem {
+                text: Backend.liveEnabled ? "Piilota sekunnit" : "Näytä sekunnit"
+                onClicked: Backend.liveEnabled = !Backend.liveEnabled
+            }
             MenuItem {
                 text: "Ruoka"
                 onClicked: pageStack.push(Qt.resolvedUrl("FoodPage.qml"))
@@ -68,31 +76,39 @@ Page {
             }
             Label {
                 x: Theme.paddingLarge
-                text: backend.tjInDays
+                text: Backend.remaining.morningsText
                 color: Theme.secondaryHighlightColor
                 font.pixelSize: Theme.fontSizeExtraLarge
             }
 
+            Label {
+                x: Theme.paddingLarge
+                visible: Backend.live
+                text: Backend.countdown
+                color: Theme.secondaryHighlightColor
+                font.pixelSize: Theme.fontSizeLarge
+            }
+
             ProgressBar {
                 minimumValue: 0
                 maximumValue: 100
                 id: tjbar
                 //x: Theme.paddingLarge
                 valueText: value.toFixed(2) + "%"
-                value: backend.daysDone
+                value: Backend.daysDone
                 width: page.width
             }
 
             Label {
                 x: Theme.paddingLarge
-                text: backend.tjInMonths
+                text: Backend.remaining.monthsText
                 color: Theme.secondaryHighlightColor
                 font.pixelSize: Theme.fontSizeExtraLarge
             }
 
             Label {
                 x: Theme.paddingLarge
-                text: backend.tjInWeeks
+                text: Backend.remaining.weeksText
                 color: Theme.secondaryHighlightColor
                 font.pixelSize: Theme.fontSizeExtraLarge
             }
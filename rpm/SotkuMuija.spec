@@ -21,11 +21,12 @@ URL:        http://example.org/
 Source0:    %{name}-%{version}.tar.bz2
 Source100:  SotkuMuija.yaml
 Requires:   sailfishsilica-qt5 >= 0.10.9
-Requires:   qt5-qtdeclarative-import-xmllistmodel
 BuildRequires:  pkgconfig(sailfishapp) >= 0.0.10
 BuildRequires:  pkgconfig(Qt5Core)
 BuildRequires:  pkgconfig(Qt5Qml)
 BuildRequires:  pkgconfig(Qt5Quick)
+BuildRequires:  pkgconfig(Qt5DBus)
+BuildRequires:  pkgconfig(Qt5Network)
 BuildRequires:  desktop-file-utils
 
 %description
@@ -46,6 +47,10 @@ TJ laskuri 1/14 saapumiserälle joka osaa myös näyttää ruuan
 %qtc_make %{?_smp_mflags}
 
 # >> build post
+cd tjd
+%qtc_qmake5
+%qtc_make %{?_smp_mflags}
+cd ..
 # << build post
 
 %install
@@ -55,6 +60,7 @@ rm -rf %{buildroot}
 %qmake5_install
 
 # >> install post
+make -C tjd install INSTALL_ROOT=%{buildroot}
 # << install post
 
 desktop-file-install --delete-original       \
@@ -72,4 +78,5 @@ desktop-file-install --delete-original       \
 %{_datadir}/%{name}/qml
 %{_bindir}
 # >> files
+%{_datadir}/dbus-1/services/fi.sotkumuija.Tj.service
 # << files
@@ -32,9 +32,54 @@
 #include <QtQuick>
 #endif
 
+#include <QtQml>
 #include <sailfishapp.h>
 #include "tjcalculatorbackend.h"
+#include "roster.h"
+#include "rosterimporter.h"
+#include "rosterleaderboard.h"
+#include "kioskserver.h"
+#include "qfoodcalendar.h"
+#include "qmenusearch.h"
+#include "qmenuhistory.h"
+#include "mealconfig.h"
+#include "reminderengine.h"
+#include "visibilitytracker.h"
+#include <QStandardPaths>
+#include <QFile>
 
+// QML-singletonit, oliot luodaan main():ssa ennen näkymää
+static TjCalculatorBackend *backendInstance = 0;
+static RosterLeaderboard *leaderboardInstance = 0;
+static QFoodCalendar *menuInstance = 0;
+static MealConfig *mealConfigInstance = 0;
+static VisibilityTracker *visibilityInstance = 0;
+
+// olioiden omistaja on main(), QML ei saa tuhota niitä
+static QObject *cppOwned(QQmlEngine *engine, QObject *object) {
+    engine->setObjectOwnership(object, QQmlEngine::CppOwnership);
+    return object;
+}
+
+static QObject *backendSingleton(QQmlEngine *engine, QJSEngine *) {
+    return cppOwned(engine, backendInstance);
+}
+
+static QObject *leaderboardSingleton(QQmlEngine *engine, QJSEngine *) {
+    return cppOwned(engine, leaderboardInstance);
+}
+
+static QObject *menuSingleton(QQmlEngine *engine, QJSEngine *) {
+    return cppOwned(engine, menuInstance);
+}
+
+static QObject *mealConfigSingleton(QQmlEngine *engine, QJSEngine *) {
+    return cppOwned(engine, mealConfigInstance);
+}
+
+static QObject *visibilitySingleton(QQmlEngine *engine, QJSEngine *) {
+    return cppOwned(engine, visibilityInstance);
+}
 
 int main(int argc, char *argv[])
 {
@@ -48,10 +93,70 @@ int main(int argc, char *argv[])
     // To display the view, call "show()" (will show fullscreen on device).
     QScopedPointer<QGuiApplication> app(SailfishApp::application(argc, argv));
 
+    qmlRegisterType<QFoodCalendar>("SotkuMuija", 1, 0, "FoodCalendar");
+    qmlRegisterType<QMenuSearch>("SotkuMuija", 1, 0, "MenuSearch");
+    qmlRegisterType<QMenuHistory>("SotkuMuija", 1, 0, "MenuHistory");
+    qmlRegisterUncreatableType<QTimeSpanValue>("SotkuMuija", 1, 0, "TimeSpan", "TimeSpan is read-only, use Backend.remaining");
+
     QScopedPointer<QQuickView> view(SailfishApp::createView());
     QScopedPointer<TjCalculatorBackend> backend(new TjCalculatorBackend);
+    QScopedPointer<Roster> roster(new Roster);
+    QScopedPointer<RosterLeaderboard> leaderboard(new RosterLeaderboard(roster.data()));
+
+    // yhteinen ruokalista, kansi tarvitsee sitä vaikka ruokasivua ei avattaisi
+    QScopedPointer<QFoodCalendar> foodCalendar(new QFoodCalendar);
+    foodCalendar->setSource(QUrl("https://dl.dropboxusercontent.com/u/22171160/food.xml"));
+
+    // ruoka-ajat: asennettu config.json oletuksina, muokkaukset datakansioon
+    QString configFile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/config.json";
+    QScopedPointer<MealConfig> mealConfig(new MealConfig(configFile, SailfishApp::pathTo("config.json").toLocalFile()));
+    foodCalendar->setMealConfig(mealConfig.data());
+
+    // SOTKUMUIJA_REMINDER_LOG: muistutukset lokiin ilmoitusten sijaan
+    ReminderSink *sink;
+    if (qgetenv("SOTKUMUIJA_REMINDER_LOG").isEmpty())
+        sink = new NotificationReminderSink;
+    else
+        sink = new LogReminderSink;
+    QScopedPointer<ReminderEngine> reminders(new ReminderEngine(foodCalendar.data(), mealConfig.data(), sink));
+
+    QString rosterFile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/roster.csv";
+    if (QFile::exists(rosterFile))
+        RosterImporter().importFile(rosterFile, roster.data());
+
+    // seinänäytöille, käynnistyy vain kun portti on annettu
+    QScopedPointer<KioskServer> kiosk;
+    quint16 kioskPort = qgetenv("SOTKUMUIJA_KIOSK_PORT").toUShort();
+    if (kioskPort) {
+        kiosk.reset(new KioskServer);
+        if (kiosk->start(kioskPort)) {
+            kiosk->setBackend(backend.data());
+            kiosk->setFoodCalendar(foodCalendar.data());
+        } else {
+            kiosk.reset();
+        }
+    }
+
+    // piilossa ei päivitetä mitään, näkyviin tultaessa kerran kerralla.
+    // Muistutukset jatkavat taustalla, samoin kioskin syötteet.
+    QScopedPointer<VisibilityTracker> visibility(new VisibilityTracker);
+    QObject::connect(visibility.data(), SIGNAL(visibleChanged(bool)), leaderboard.data(), SLOT(setActive(bool)));
+    if (!kiosk) {
+        QObject::connect(visibility.data(), SIGNAL(visibleChanged(bool)), backend.data(), SLOT(setActive(bool)));
+        QObject::connect(visibility.data(), SIGNAL(visibleChanged(bool)), foodCalendar.data(), SLOT(setActive(bool)));
+    }
+
+    backendInstance = backend.data();
+    leaderboardInstance = leaderboard.data();
+    menuInstance = foodCalendar.data();
+    mealConfigInstance = mealConfig.data();
+    visibilityInstance = visibility.data();
+    qmlRegisterSingletonType<TjCalculatorBackend>("SotkuMuija", 1, 0, "Backend", backendSingleton);
+    qmlRegisterSingletonType<RosterLeaderboard>("SotkuMuija", 1, 0, "Leaderboard", leaderboardSingleton);
+    qmlRegisterSingletonType<QFoodCalendar>("SotkuMuija", 1, 0, "Menu", menuSingleton);
+    qmlRegisterSingletonType<MealConfig>("SotkuMuija", 1, 0, "MealConfig", mealConfigSingleton);
+    qmlRegisterSingletonType<VisibilityTracker>("SotkuMuija", 1, 0, "Visibility", visibilitySingleton);
 
-    view->rootContext()->setContextProperty("backend", backend.data());
     view->setSource(SailfishApp::pathTo("qml/SotkuMuija.qml"));
     view->show();
     return app->exec();
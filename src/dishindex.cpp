@@ -0,0 +1,159 @@
+#include "dishindex.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+bool DishIndex::addDay(const QDate &date, const QString meals[MealSlotCount]) {
+    if (!date.isValid())
+        return false;
+    qint64 julianDay = date.toJulianDay();
+    DayMeals &day = days[julianDay];
+    bool changed = false;
+
+    for (int slot = 0; slot < MealSlotCount; ++slot) {
+        // sama ruoka kuin ennen, ei kosketa postauslistoihin
+        if (day.meals[slot] == meals[slot])
+            continue;
+        Posting posting = { julianDay, slot };
+        foreach (const QString &word, tokenize(day.meals[slot])) {
+            removePosting(words, word, posting);
+            removePosting(foldedWords, fold(word), posting);
+        }
+        foreach (const QString &word, tokenize(meals[slot])) {
+            insertPosting(words, word, posting);
+            insertPosting(foldedWords, fold(word), posting);
+        }
+        day.meals[slot] = meals[slot];
+        changed = true;
+    }
+    return changed;
+}
+
+QVector<DishIndex::Posting> DishIndex::search(const QString &query, const QDate &from, const QDate &to) const {
+    qint64 first = from.isValid() ? from.toJulianDay() : std::numeric_limits<qint64>::min();
+    qint64 last = to.isValid() ? to.toJulianDay() : std::numeric_limits<qint64>::max();
+
+    Postings result;
+    QStringList queryWords = tokenize(query, 1);
+    for (int i = 0; i < queryWords.count(); ++i) {
+        Postings matches = prefixMatches(queryWords.at(i), first, last);
+        if (i == 0) {
+            result = matches;
+        } else {
+            Postings both;
+            std::set_intersection(result.constBegin(), result.constEnd(),
+                                  matches.constBegin(), matches.constEnd(), std::back_inserter(both));
+            result = both;
+        }
+        if (result.isEmpty())
+            break;
+    }
+    return result;
+}
+
+QString DishIndex::text(const Posting &posting) const {
+    QHash<qint64, DayMeals>::const_iterator it = days.constFind(posting.julianDay);
+    return it == days.constEnd() ? QString() : it.value().meals[posting.slot];
+}
+
+// pienet kirjaimet ja aksentit pois, mutta ä, ö ja å säilyvät
+QString DishIndex::normalize(const QString &text) {
+    QString decomposed = text.toCaseFolded().normalized(QString::NormalizationForm_D);
+    QString result;
+    result.reserve(decomposed.size());
+    for (int i = 0; i < decomposed.size(); ++i) {
+        QChar c = decomposed.at(i);
+        if (c.category() != QChar::Mark_NonSpacing) {
+            result += c;
+            continue;
+        }
+        QChar base = result.isEmpty() ? QChar() : result.at(result.size() - 1);
+        if ((c.unicode() == 0x0308 && (base == QLatin1Char('a') || base == QLatin1Char('o')))
+                || (c.unicode() == 0x030a && base == QLatin1Char('a')))
+            result += c;
+    }
+    return result.normalized(QString::NormalizationForm_C);
+}
+
+QString DishIndex::fold(const QString &word) {
+    QString folded = word;
+    for (int i = 0; i < folded.size(); ++i) {
+        ushort c = folded.at(i).unicode();
+        if (c == 0x00e4 || c == 0x00e5)
+            folded[i] = QLatin1Char('a');
+        else if (c == 0x00f6)
+            folded[i] = QLatin1Char('o');
+    }
+    return folded;
+}
+
+QStringList DishIndex::tokenize(const QString &text, int minLength) {
+    QStringList result;
+    QString normalized = normalize(text);
+    int start = -1;
+    for (int i = 0; i <= normalized.size(); ++i) {
+        bool letter = i < normalized.size() && normalized.at(i).isLetterOrNumber();
+        if (letter && start < 0) {
+            start = i;
+        } else if (!letter && start >= 0) {
+            if (i - start >= minLength)
+                result.append(normalized.mid(start, i - start));
+            start = -1;
+        }
+    }
+    return result;
+}
+
+void DishIndex::insertPosting(QMap<QString, Postings> &map, const QString &word, const Posting &posting) {
+    Postings &postings = map[word];
+    Postings::iterator it = std::lower_bound(postings.begin(), postings.end(), posting);
+    if (it == postings.end() || !(*it == posting))
+        postings.insert(it, posting);
+}
+
+void DishIndex::removePosting(QMap<QString, Postings> &map, const QString &word, const Posting &posting) {
+    QMap<QString, Postings>::iterator entry = map.find(word);
+    if (entry == map.end())
+        return;
+    Postings &postings = entry.value();
+    Postings::iterator it = std::lower_bound(postings.begin(), postings.end(), posting);
+    if (it != postings.end() && *it == posting)
+        postings.erase(it);
+    if (postings.isEmpty())
+        map.erase(entry);
+}
+
+// kaikki sanat jotka alkavat wordilla, päivävälille rajattuna ja järjestettynä
+DishIndex::Postings DishIndex::prefixMatches(const QString &word, qint64 from, qint64 to) const {
+    bool exact = fold(word) != word;
+    const QMap<QString, Postings> &map = exact ? words : foldedWords;
+
+    Posting low = { from, 0 };
+    Posting high = { to, MealSlotCount };
+    // ensin kerätään osuvat välit, yhdistetään vasta lopuksi kerralla
+    QVector<QPair<Postings::const_iterator, Postings::const_iterator> > ranges;
+    int total = 0;
+    QMap<QString, Postings>::const_iterator it = map.lowerBound(word);
+    for (; it != map.constEnd() && it.key().startsWith(word); ++it) {
+        const Postings &postings = it.value();
+        Postings::const_iterator begin = std::lower_bound(postings.constBegin(), postings.constEnd(), low);
+        Postings::const_iterator end = std::lower_bound(begin, postings.constEnd(), high);
+        if (begin == end)
+            continue;
+        ranges.append(qMakePair(begin, end));
+        total += end - begin;
+    }
+
+    Postings result;
+    result.reserve(total);
+    for (int i = 0; i < ranges.count(); ++i) {
+        for (Postings::const_iterator p = ranges.at(i).first; p != ranges.at(i).second; ++p)
+            result.append(*p);
+    }
+    // yksi väli on jo järjestyksessä ja ilman toistoja
+    if (ranges.count() > 1) {
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    return result;
+}
@@ -0,0 +1,73 @@
+#ifndef DISHINDEX_H
+#define DISHINDEX_H
+
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QDate>
+#include <QMetaType>
+#include "menuday.h"
+
+// Inverted index over every menu seen so far: dish words point to the
+// (date, meal) pairs they were served at. Words are case-folded and
+// stripped of accents, except that ä, ö and å are kept as letters of their
+// own. Each word is also filed under its plain a/o spelling, so a query
+// typed without them still finds "jäätelö".
+//
+// Queries match word prefixes; several words must all match. Postings are
+// kept sorted by date so a date range is two binary searches. Indexed words
+// are at least two letters, but a query word may be a single letter so
+// the first keystroke of a search already finds something.
+class DishIndex
+{
+public:
+    struct Posting {
+        qint64 julianDay;
+        int slot;
+
+        inline bool operator<(const Posting &other) const {
+            return julianDay < other.julianDay || (julianDay == other.julianDay && slot < other.slot);
+        }
+        inline bool operator==(const Posting &other) const {
+            return julianDay == other.julianDay && slot == other.slot;
+        }
+    };
+
+    // päivä korvaa saman päivän aiemman sisällön, false jos mikään ei muuttunut
+    bool addDay(const QDate &date, const QString meals[MealSlotCount]);
+
+    QVector<Posting> search(const QString &query, const QDate &from = QDate(), const QDate &to = QDate()) const;
+
+    QString text(const Posting &posting) const;
+
+    inline int dayCount() const {
+        return days.count();
+    }
+
+    static QString normalize(const QString &text);
+    static QString fold(const QString &word);
+    // minLength-lyhyemmät sanat jätetään pois
+    static QStringList tokenize(const QString &text, int minLength = 2);
+
+private:
+    typedef QVector<Posting> Postings;
+
+    struct DayMeals {
+        QString meals[MealSlotCount];
+    };
+
+    void insertPosting(QMap<QString, Postings> &map, const QString &word, const Posting &posting);
+    void removePosting(QMap<QString, Postings> &map, const QString &word, const Posting &posting);
+    Postings prefixMatches(const QString &word, qint64 from, qint64 to) const;
+
+    QMap<QString, Postings> words;
+    QMap<QString, Postings> foldedWords;
+    QHash<qint64, DayMeals> days;
+};
+
+Q_DECLARE_TYPEINFO(DishIndex::Posting, Q_PRIMITIVE_TYPE);
+Q_DECLARE_METATYPE(DishIndex)
+
+#endif // DISHINDEX_H
@@ -0,0 +1,17 @@
+#include "dishpool.h"
+
+DishPool::DishPool()
+{
+    strings.append(QString());
+    ids.insert(QString(), 0);
+}
+
+quint32 DishPool::intern(const QString &text) {
+    QHash<QString, quint32>::const_iterator it = ids.constFind(text);
+    if (it != ids.constEnd())
+        return it.value();
+    quint32 id = strings.count();
+    strings.append(text);
+    ids.insert(text, id);
+    return id;
+}
@@ -0,0 +1,31 @@
+#ifndef DISHPOOL_H
+#define DISHPOOL_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+// Interned menu strings. Garrison menus repeat the same dishes week after
+// week, so every distinct text is stored once and rows refer to it by a
+// 32-bit id. Id 0 is always the empty string.
+class DishPool
+{
+public:
+    DishPool();
+
+    quint32 intern(const QString &text);
+
+    inline const QString &text(quint32 id) const {
+        return strings.at(id);
+    }
+
+    inline int count() const {
+        return strings.count();
+    }
+
+private:
+    QVector<QString> strings;
+    QHash<QString, quint32> ids;
+};
+
+#endif // DISHPOOL_H
@@ -0,0 +1,302 @@
+#include "kioskserver.h"
+#include "tjcalculatorbackend.h"
+#include "qfoodcalendar.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+static const int MaxHeaderSize = 8 * 1024;
+static const qint64 MaxPendingBytes = 1024 * 1024;
+static const qint64 IdleTimeout = 30 * 1000;
+static const char EventsPath[] = "/events";
+
+static QByteArray headerValue(const QList<QByteArray> &lines, const char *name) {
+    int length = qstrlen(name);
+    for (int i = 1; i < lines.count(); ++i) {
+        const QByteArray &line = lines.at(i);
+        if (line.size() > length && line.at(length) == ':' && qstrnicmp(line.constData(), name, length) == 0)
+            return line.mid(length + 1).trimmed();
+    }
+    return QByteArray();
+}
+
+KioskServerWorker::KioskServerWorker(QObject *parent) :
+    QObject(parent), server(0), sweepTimer(0)
+{
+}
+
+bool KioskServerWorker::listen(quint16 port) {
+    clock.start();
+    server = new QTcpServer(this);
+    server->setMaxPendingConnections(256);
+    connect(server, SIGNAL(newConnection()), this, SLOT(acceptConnections()));
+    if (!server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "kiosk: cannot listen on port" << port << server->errorString();
+        return false;
+    }
+
+    sweepTimer = new QTimer(this);
+    sweepTimer->setInterval(10 * 1000);
+    connect(sweepTimer, SIGNAL(timeout()), this, SLOT(sweepClients()));
+    sweepTimer->start();
+    return true;
+}
+
+void KioskServerWorker::setDocument(const QByteArray &path, const QByteArray &body) {
+    Document &document = documents[path];
+    if (document.body == body)
+        return;
+    document.body = body;
+    document.etag = '"' + QCryptographicHash::hash(body, QCryptographicHash::Md5).toHex().left(16) + '"';
+
+    QList<QTcpSocket *> slowClients;
+    QHash<QTcpSocket *, Client>::const_iterator it;
+    for (it = clients.constBegin(); it != clients.constEnd(); ++it) {
+        if (it.value().streaming && !sendEvent(it.key(), path, body))
+            slowClients.append(it.key());
+    }
+    // liian hitaat lukijat pudotetaan, ei jäädä puskuroimaan loputtomiin
+    foreach (QTcpSocket *socket, slowClients) {
+        clients.remove(socket);
+        socket->abort();
+    }
+}
+
+void KioskServerWorker::stop() {
+    foreach (QTcpSocket *socket, clients.keys())
+        socket->abort();
+    clients.clear();
+    delete server;
+    server = 0;
+    delete sweepTimer;
+    sweepTimer = 0;
+}
+
+void KioskServerWorker::acceptConnections() {
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        Client &client = clients[socket];
+        client.lastActive = clock.elapsed();
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readClient()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    }
+}
+
+void KioskServerWorker::readClient() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket || !clients.contains(socket))
+        return;
+
+    Client &client = clients[socket];
+    client.lastActive = clock.elapsed();
+    if (client.streaming) {
+        // event streamin aikana asiakas ei saa lähettää mitään
+        socket->readAll();
+        return;
+    }
+
+    client.buffer += socket->readAll();
+    for (;;) {
+        int headEnd = client.buffer.indexOf("\r\n\r\n");
+        if (headEnd < 0) {
+            if (client.buffer.size() > MaxHeaderSize) {
+                sendResponse(socket, "431 Request Header Fields Too Large", QByteArray(), QByteArray(), false);
+                clients.remove(socket);
+            }
+            return;
+        }
+        QByteArray head = client.buffer.left(headEnd);
+        client.buffer.remove(0, headEnd + 4);
+        if (!handleRequest(socket, client, head)) {
+            clients.remove(socket);
+            return;
+        }
+        if (client.streaming)
+            return;
+    }
+}
+
+void KioskServerWorker::clientDisconnected() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket)
+        return;
+    clients.remove(socket);
+    socket->deleteLater();
+}
+
+void KioskServerWorker::sweepClients() {
+    qint64 now = clock.elapsed();
+    QList<QTcpSocket *> idleClients;
+    QHash<QTcpSocket *, Client>::const_iterator it;
+    for (it = clients.constBegin(); it != clients.constEnd(); ++it) {
+        if (it.value().streaming) {
+            // kommenttirivi pitää yhteyden auki ja paljastaa kuolleet asiakkaat
+            it.key()->write(": ping\n\n");
+        } else if (now - it.value().lastActive > IdleTimeout) {
+            idleClients.append(it.key());
+        }
+    }
+    foreach (QTcpSocket *socket, idleClients) {
+        clients.remove(socket);
+        socket->disconnectFromHost();
+    }
+}
+
+// palauttaa false jos yhteys suljetaan
+bool KioskServerWorker::handleRequest(QTcpSocket *socket, Client &client, const QByteArray &head) {
+    QList<QByteArray> lines = head.split('\n');
+    for (int i = 0; i < lines.count(); ++i) {
+        if (lines.at(i).endsWith('\r'))
+            lines[i].chop(1);
+    }
+
+    QList<QByteArray> requestLine = lines.first().split(' ');
+    if (requestLine.count() != 3) {
+        sendResponse(socket, "400 Bad Request", QByteArray(), QByteArray(), false);
+        return false;
+    }
+    const QByteArray &method = requestLine.at(0);
+    QByteArray path = requestLine.at(1);
+    const QByteArray &version = requestLine.at(2);
+    int query = path.indexOf('?');
+    if (query >= 0)
+        path.truncate(query);
+
+    QByteArray connection = headerValue(lines, "Connection").toLower();
+    bool keepAlive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+    if (method != "GET" && method != "HEAD") {
+        sendResponse(socket, "405 Method Not Allowed", "Allow: GET, HEAD\r\n", QByteArray(), false);
+        return false;
+    }
+
+    if (path == EventsPath && method == "GET") {
+        client.streaming = true;
+        socket->write("HTTP/1.1 200 OK\r\n"
+                      "Content-Type: text/event-stream\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "Connection: keep-alive\r\n\r\n");
+        QHash<QByteArray, Document>::const_iterator it;
+        for (it = documents.constBegin(); it != documents.constEnd(); ++it)
+            sendEvent(socket, it.key(), it.value().body);
+        return true;
+    }
+
+    QHash<QByteArray, Document>::const_iterator it = documents.constFind(path);
+    if (it == documents.constEnd()) {
+        sendResponse(socket, "404 Not Found", QByteArray(), QByteArray(), keepAlive);
+        return keepAlive;
+    }
+
+    QByteArray headers = "ETag: " + it.value().etag + "\r\n"
+                         "Cache-Control: no-cache\r\n";
+    if (headerValue(lines, "If-None-Match") == it.value().etag) {
+        sendResponse(socket, "304 Not Modified", headers, QByteArray(), keepAlive);
+        return keepAlive;
+    }
+
+    headers += "Content-Type: application/json; charset=utf-8\r\n";
+    if (method == "HEAD") {
+        headers += "Content-Length: " + QByteArray::number(it.value().body.size()) + "\r\n";
+        sendResponse(socket, "200 OK", headers, QByteArray(), keepAlive);
+    } else {
+        sendResponse(socket, "200 OK", headers, it.value().body, keepAlive);
+    }
+    return keepAlive;
+}
+
+void KioskServerWorker::sendResponse(QTcpSocket *socket, const char *status, const QByteArray &headers,
+                                     const QByteArray &body, bool keepAlive) {
+    QByteArray response;
+    response.reserve(128 + headers.size() + body.size());
+    response += "HTTP/1.1 ";
+    response += status;
+    response += "\r\n";
+    response += headers;
+    if (!headers.contains("Content-Length"))
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    if (!keepAlive)
+        socket->disconnectFromHost();
+}
+
+bool KioskServerWorker::sendEvent(QTcpSocket *socket, const QByteArray &path, const QByteArray &body) {
+    if (socket->bytesToWrite() > MaxPendingBytes)
+        return false;
+    QByteArray event;
+    event.reserve(body.size() + path.size() + 16);
+    event += "event: ";
+    event += path.mid(1);
+    event += "\ndata: ";
+    event += body;
+    event += "\n\n";
+    socket->write(event);
+    return true;
+}
+
+KioskServer::KioskServer(QObject *parent) :
+    QObject(parent), worker(new KioskServerWorker), backend(0), foodCalendar(0)
+{
+    worker->moveToThread(&thread);
+    thread.setObjectName("kiosk");
+}
+
+KioskServer::~KioskServer() {
+    if (thread.isRunning()) {
+        QMetaObject::invokeMethod(worker, "stop", Qt::BlockingQueuedConnection);
+        thread.quit();
+        thread.wait();
+    }
+    delete worker;
+}
+
+bool KioskServer::start(quint16 port) {
+    thread.start();
+    bool ok = false;
+    QMetaObject::invokeMethod(worker, "listen", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, ok), Q_ARG(quint16, port));
+    if (ok)
+        qDebug() << "kiosk: serving on 127.0.0.1:" << port;
+    return ok;
+}
+
+void KioskServer::publish(const QByteArray &path, const QByteArray &json) {
+    QMetaObject::invokeMethod(worker, "setDocument", Qt::QueuedConnection,
+                              Q_ARG(QByteArray, path), Q_ARG(QByteArray, json));
+}
+
+void KioskServer::setBackend(TjCalculatorBackend *tjBackend) {
+    backend = tjBackend;
+    connect(backend, SIGNAL(calculated()), this, SLOT(publishTj()));
+    publishTj();
+}
+
+void KioskServer::publishTj() {
+    QJsonObject tj;
+    tj.insert("tjInDays", backend->getTjInDays());
+    tj.insert("tjInMonths", backend->getTjInMonths());
+    tj.insert("tjInWeeks", backend->getTjInWeeks());
+    tj.insert("daysDone", backend->getDaysDone());
+    publish("/tj", QJsonDocument(tj).toJson(QJsonDocument::Compact));
+}
+
+void KioskServer::setFoodCalendar(QFoodCalendar *calendar) {
+    foodCalendar = calendar;
+    connect(foodCalendar, SIGNAL(mealsChanged()), this, SLOT(publishMeals()));
+    publishMeals();
+}
+
+void KioskServer::publishMeals() {
+    QJsonObject meals;
+    meals.insert("currentMeal", foodCalendar->getCurrentMeal());
+    meals.insert("currentMealText", foodCalendar->getCurrentMealText());
+    meals.insert("nextMeal", foodCalendar->getNextMeal());
+    meals.insert("nextMealText", foodCalendar->getNextMealText());
+    meals.insert("nextTransition", foodCalendar->getNextTransition().toString(Qt::ISODate));
+    publish("/meals", QJsonDocument(meals).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,88 @@
+#ifndef KIOSKSERVER_H
+#define KIOSKSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+class TjCalculatorBackend;
+class QFoodCalendar;
+
+// Lives in the server thread and owns every socket. Documents are plain
+// JSON blobs keyed by their path, pushed in from the GUI thread.
+class KioskServerWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit KioskServerWorker(QObject *parent = 0);
+
+public slots:
+    bool listen(quint16 port);
+    void setDocument(const QByteArray &path, const QByteArray &body);
+    void stop();
+
+private slots:
+    void acceptConnections();
+    void readClient();
+    void clientDisconnected();
+    void sweepClients();
+
+private:
+    struct Document {
+        QByteArray body;
+        QByteArray etag;
+    };
+
+    struct Client {
+        Client() : lastActive(0), streaming(false) {}
+        QByteArray buffer;
+        qint64 lastActive;
+        bool streaming;
+    };
+
+    bool handleRequest(QTcpSocket *socket, Client &client, const QByteArray &head);
+    void sendResponse(QTcpSocket *socket, const char *status, const QByteArray &headers,
+                      const QByteArray &body, bool keepAlive);
+    bool sendEvent(QTcpSocket *socket, const QByteArray &path, const QByteArray &body);
+
+    QTcpServer *server;
+    QTimer *sweepTimer;
+    QElapsedTimer clock;
+    QHash<QByteArray, Document> documents;
+    QHash<QTcpSocket *, Client> clients;
+};
+
+// Optional HTTP/1.1 endpoint on localhost for wall displays. Serves the
+// published documents with ETag revalidation and streams changes as
+// server-sent events from /events. All socket work happens in its own
+// thread; the GUI thread only hands over finished JSON.
+class KioskServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit KioskServer(QObject *parent = 0);
+    ~KioskServer();
+
+    bool start(quint16 port);
+    void publish(const QByteArray &path, const QByteArray &json);
+
+    void setBackend(TjCalculatorBackend *backend);
+    void setFoodCalendar(QFoodCalendar *calendar);
+
+private slots:
+    void publishTj();
+    void publishMeals();
+
+private:
+    QThread thread;
+    KioskServerWorker *worker;
+    TjCalculatorBackend *backend;
+    QFoodCalendar *foodCalendar;
+};
+
+#endif // KIOSKSERVER_H
@@ -0,0 +1,153 @@
+#include "mealconfig.h"
+#include "menuparser.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QTime>
+#include <QDebug>
+
+MealConfig::MealConfig(const QString &fileName, const QString &defaultsFileName, QObject *parent) :
+    QObject(parent), fileName(fileName), defaultsFileName(defaultsFileName), reminderMinutes(0)
+{
+    // peräkkäiset muutokset kirjoitetaan kerralla
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(500);
+    connect(&saveTimer, SIGNAL(timeout()), this, SLOT(save()));
+    connect(&watcher, SIGNAL(fileChanged(QString)), this, SLOT(fileChanged()));
+    connect(&watcher, SIGNAL(directoryChanged(QString)), this, SLOT(fileChanged()));
+    load();
+}
+
+QVariantMap MealConfig::getTimes() const {
+    QVariantMap times;
+    for (int slot = 0; slot < MealSlotCount; ++slot) {
+        QTime time(schedule.start[slot] / 60, schedule.start[slot] % 60);
+        times.insert(MenuParser::slotElement(MealSlot(slot)), time.toString("hh:mm"));
+    }
+    return times;
+}
+
+void MealConfig::setMealTime(const QString &meal, int hour, int minute) {
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59)
+        return;
+    for (int slot = 0; slot < MealSlotCount; ++slot) {
+        if (meal != MenuParser::slotElement(MealSlot(slot)))
+            continue;
+        int start = hour * 60 + minute;
+        if (schedule.start[slot] == start)
+            return;
+        schedule.start[slot] = start;
+        object.insert(meal, QTime(hour, minute).toString("hh:mm"));
+        saveTimer.start();
+        emit scheduleChanged();
+        return;
+    }
+    qWarning() << "config: unknown meal" << meal;
+}
+
+void MealConfig::setReminderMinutes(int minutes) {
+    minutes = qBound(0, minutes, 24 * 60);
+    if (minutes == reminderMinutes)
+        return;
+    reminderMinutes = minutes;
+    object.insert("reminder", minutes);
+    saveTimer.start();
+    emit reminderMinutesChanged();
+}
+
+bool MealConfig::parse(const QByteArray &json, MealSchedule &result, QJsonObject &parsed, QString &error) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (!document.isObject()) {
+        error = parseError.errorString();
+        return false;
+    }
+
+    MealSchedule compiled;
+    QJsonObject root = document.object();
+    for (int slot = 0; slot < MealSlotCount; ++slot) {
+        QJsonValue value = root.value(MenuParser::slotElement(MealSlot(slot)));
+        if (value.isUndefined())
+            continue;
+        QTime time = QTime::fromString(value.toString(), "hh:mm");
+        if (!time.isValid())
+            time = QTime::fromString(value.toString(), "H:mm");
+        if (!time.isValid()) {
+            error = QString("bad time for %1: %2").arg(MenuParser::slotElement(MealSlot(slot)), value.toString());
+            return false;
+        }
+        compiled.start[slot] = time.hour() * 60 + time.minute();
+    }
+    result = compiled;
+    parsed = root;
+    return true;
+}
+
+void MealConfig::load() {
+    QString path = QFile::exists(fileName) ? fileName : defaultsFileName;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "config: cannot read" << path << file.errorString();
+        return;
+    }
+
+    MealSchedule loaded;
+    QString error;
+    if (!parse(file.readAll(), loaded, object, error)) {
+        qWarning() << "config:" << path << error << "- keeping previous schedule";
+        watch(path);
+        return;
+    }
+    watch(path);
+
+    int minutes = qBound(0, object.value("reminder").toInt(), 24 * 60);
+    if (minutes != reminderMinutes) {
+        reminderMinutes = minutes;
+        emit reminderMinutesChanged();
+    }
+    if (loaded == schedule)
+        return;
+    schedule = loaded;
+    emit scheduleChanged();
+}
+
+void MealConfig::save() {
+    saveTimer.stop();
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+    // QSaveFile kirjoittaa väliaikaiseen ja nimeää sen lopuksi
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "config: cannot write" << fileName << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(object).toJson());
+    if (!file.commit())
+        qWarning() << "config: cannot write" << fileName << file.errorString();
+}
+
+void MealConfig::fileChanged() {
+    // oma tallennus on vielä tulossa, levyllä oleva on vanhempi
+    if (saveTimer.isActive())
+        return;
+    // tallennus korvaa tiedoston, joten vahti asetetaan joka kerta uudelleen
+    load();
+}
+
+void MealConfig::watch(const QString &path) {
+    if (!watcher.files().isEmpty())
+        watcher.removePaths(watcher.files());
+    watcher.addPath(path);
+
+    // kirjoitettava kopio voi syntyä myöhemmin. Kun se on olemassa,
+    // hakemiston muut kirjoitukset eivät enää kuulu tälle.
+    QString directory = QFileInfo(fileName).absolutePath();
+    if (path == fileName) {
+        if (!watcher.directories().isEmpty())
+            watcher.removePaths(watcher.directories());
+    } else if (QFileInfo(directory).isDir() && !watcher.directories().contains(directory)) {
+        watcher.addPath(directory);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef MEALCONFIG_H
+#define MEALCONFIG_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <QJsonObject>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include "mealschedule.h"
+
+// config.json compiled into a MealSchedule. The installed file holds the
+// defaults; edits from the settings page go to a writable copy that is
+// written atomically after a short pause. The file in use is watched, and
+// the copy's directory until the copy exists, so a changed file takes
+// effect without a restart. A file that does not parse leaves
+// the current schedule in place. "reminder" is how many minutes before a
+// meal the reminder engine gives a heads-up, 0 turns reminders off.
+class MealConfig : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QVariantMap times READ getTimes NOTIFY scheduleChanged)
+    Q_PROPERTY(int reminderMinutes READ getReminderMinutes WRITE setReminderMinutes NOTIFY reminderMinutesChanged)
+
+public:
+    MealConfig(const QString &fileName, const QString &defaultsFileName, QObject *parent = 0);
+
+    inline const MealSchedule &getSchedule() const {
+        return schedule;
+    }
+
+    // avaimina ateriat ("breakfast"...), arvoina "hh:mm"
+    QVariantMap getTimes() const;
+
+    Q_INVOKABLE void setMealTime(const QString &meal, int hour, int minute);
+
+    inline int getReminderMinutes() const {
+        return reminderMinutes;
+    }
+    void setReminderMinutes(int minutes);
+
+    static bool parse(const QByteArray &json, MealSchedule &schedule, QJsonObject &object, QString &error);
+
+public slots:
+    void load();
+    void save();
+
+signals:
+    void scheduleChanged();
+    void reminderMinutesChanged();
+
+private slots:
+    void fileChanged();
+
+private:
+    void watch(const QString &path);
+
+    QString fileName;
+    QString defaultsFileName;
+    MealSchedule schedule;
+    int reminderMinutes;
+    QJsonObject object;
+    QFileSystemWatcher watcher;
+    QTimer saveTimer;
+};
+
+#endif // MEALCONFIG_H
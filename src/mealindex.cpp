@@ -0,0 +1,54 @@
+#include "mealindex.h"
+
+MealIndex::MealIndex()
+{
+    schedule.ordered(order);
+}
+
+void MealIndex::setSchedule(const MealSchedule &value) {
+    schedule = value;
+    schedule.ordered(order);
+}
+
+void MealIndex::clear() {
+    days.clear();
+}
+
+void MealIndex::insert(const QDate &date, const QString meals[MealSlotCount]) {
+    if (!date.isValid())
+        return;
+    DayMeals &day = days[date.toJulianDay()];
+    for (int slot = 0; slot < MealSlotCount; ++slot)
+        day.meals[slot] = meals[slot];
+}
+
+QString MealIndex::text(const QDate &date, int slot) const {
+    QHash<qint64, DayMeals>::const_iterator it = days.constFind(date.toJulianDay());
+    return it == days.constEnd() ? QString() : it.value().meals[slot];
+}
+
+MealIndex::Meal MealIndex::current(const QDateTime &at) const {
+    int minutes = at.time().hour() * 60 + at.time().minute();
+    for (int i = MealSlotCount - 1; i >= 0; --i) {
+        if (schedule.start[order[i]] <= minutes)
+            return meal(at.date(), order[i]);
+    }
+    return Meal();
+}
+
+MealIndex::Meal MealIndex::next(const QDateTime &at) const {
+    int minutes = at.time().hour() * 60 + at.time().minute();
+    for (int i = 0; i < MealSlotCount; ++i) {
+        if (schedule.start[order[i]] > minutes)
+            return meal(at.date(), order[i]);
+    }
+    return meal(at.date().addDays(1), order[0]);
+}
+
+MealIndex::Meal MealIndex::meal(const QDate &date, int slot) const {
+    Meal result;
+    result.slot = slot;
+    result.start = QDateTime(date, QTime(schedule.start[slot] / 60, schedule.start[slot] % 60));
+    result.text = text(date, slot);
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef MEALINDEX_H
+#define MEALINDEX_H
+
+#include <QDateTime>
+#include <QHash>
+#include "menuday.h"
+#include "mealschedule.h"
+
+// Answers "which meal is current or next at instant t and what is served"
+// without scanning the menu: days are hashed by date and the handful of
+// meal slots are checked directly. Plain value type, cheap to copy.
+class MealIndex
+{
+public:
+    struct Meal {
+        Meal() : slot(-1) {}
+
+        inline bool isValid() const {
+            return slot >= 0;
+        }
+
+        int slot;
+        QDateTime start;
+        QString text;
+    };
+
+    MealIndex();
+
+    inline const MealSchedule &getSchedule() const {
+        return schedule;
+    }
+    void setSchedule(const MealSchedule &schedule);
+
+    void clear();
+    void insert(const QDate &date, const QString meals[MealSlotCount]);
+
+    QString text(const QDate &date, int slot) const;
+
+    // viimeisin jo alkanut ateria samana päivänä
+    Meal current(const QDateTime &at) const;
+    // seuraava alkava ateria, tarvittaessa huomisen puolelta
+    Meal next(const QDateTime &at) const;
+
+    inline QDateTime nextTransition(const QDateTime &at) const {
+        return next(at).start;
+    }
+
+private:
+    struct DayMeals {
+        QString meals[MealSlotCount];
+    };
+
+    Meal meal(const QDate &date, int slot) const;
+
+    MealSchedule schedule;
+    int order[MealSlotCount];
+    QHash<qint64, DayMeals> days;
+};
+
+#endif // MEALINDEX_H
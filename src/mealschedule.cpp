@@ -0,0 +1,41 @@
+#include "mealschedule.h"
+
+MealSchedule::MealSchedule()
+{
+    start[Breakfast] = 10 * 60;
+    start[Lunch] = 12 * 60;
+    start[Dinner] = 17 * 60 + 30;
+    start[Supper] = 19 * 60;
+}
+
+bool MealSchedule::operator==(const MealSchedule &other) const {
+    for (int i = 0; i < MealSlotCount; ++i) {
+        if (start[i] != other.start[i])
+            return false;
+    }
+    return true;
+}
+
+void MealSchedule::ordered(int slots[MealSlotCount]) const {
+    for (int i = 0; i < MealSlotCount; ++i)
+        slots[i] = i;
+    // neljä alkiota, lisäyslajittelu riittää
+    for (int i = 1; i < MealSlotCount; ++i) {
+        for (int j = i; j > 0 && start[slots[j]] < start[slots[j - 1]]; --j)
+            qSwap(slots[j], slots[j - 1]);
+    }
+}
+
+QString MealSchedule::slotTitle(int slot) {
+    switch (slot) {
+    case Breakfast:
+        return QString::fromUtf8("Aamupala");
+    case Lunch:
+        return QString::fromUtf8("Lounas");
+    case Dinner:
+        return QString::fromUtf8("Päivällinen");
+    case Supper:
+        return QString::fromUtf8("Iltapala");
+    }
+    return QString();
+}
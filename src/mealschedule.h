@@ -0,0 +1,26 @@
+#ifndef MEALSCHEDULE_H
+#define MEALSCHEDULE_H
+
+#include <QString>
+#include "menuday.h"
+
+// Start time of every meal in minutes since midnight, in MealSlot order.
+// The defaults mirror config.json.
+struct MealSchedule
+{
+    MealSchedule();
+
+    int start[MealSlotCount];
+
+    bool operator==(const MealSchedule &other) const;
+    inline bool operator!=(const MealSchedule &other) const {
+        return !(*this == other);
+    }
+
+    // slotit aikajärjestyksessä, aamupala ensin
+    void ordered(int slots[MealSlotCount]) const;
+
+    static QString slotTitle(int slot);
+};
+
+#endif // MEALSCHEDULE_H
@@ -0,0 +1,201 @@
+#include "menuarchive.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMap>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QDebug>
+#include <string.h>
+
+static const char Magic[4] = { 'S', 'M', 'M', 'A' };
+static const quint32 Version = 1;
+
+static bool sameDay(const MenuDay &a, const MenuDay &b) {
+    if (a.name != b.name)
+        return false;
+    for (int slot = 0; slot < MealSlotCount; ++slot) {
+        if (a.meals[slot] != b.meals[slot])
+            return false;
+    }
+    return true;
+}
+
+MenuArchive::MenuArchive() :
+    validSize(0)
+{
+}
+
+QString MenuArchive::defaultFileName() {
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/menus.archive";
+}
+
+bool MenuArchive::open(const QString &name) {
+    fileName = name;
+    blocks.clear();
+    validSize = 0;
+
+    QFile file(fileName);
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "menu archive: cannot open" << fileName << file.errorString();
+        fileName.clear();
+        return false;
+    }
+
+    // vain otsikot luetaan, pakatut lohkot ohitetaan
+    qint64 size = file.size();
+    qint64 offset = 0;
+    BlockHeader header;
+    while (offset + qint64(sizeof(header)) <= size) {
+        file.seek(offset);
+        if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header)))
+            break;
+        if (memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+            break;
+        qint64 end = offset + sizeof(header) + header.size;
+        if (end > size)
+            break;
+        Block block;
+        block.offset = offset;
+        block.size = header.size;
+        block.firstDay = header.firstDay;
+        block.lastDay = header.lastDay;
+        blocks.append(block);
+        offset = end;
+    }
+    validSize = offset;
+    if (validSize != size)
+        qDebug() << "menu archive: ignoring" << size - validSize << "bytes of torn tail in" << fileName;
+    return true;
+}
+
+QDate MenuArchive::firstDate() const {
+    if (blocks.isEmpty())
+        return QDate();
+    qint32 first = blocks.first().firstDay;
+    foreach (const Block &block, blocks)
+        first = qMin(first, block.firstDay);
+    return QDate::fromJulianDay(first);
+}
+
+QDate MenuArchive::lastDate() const {
+    if (blocks.isEmpty())
+        return QDate();
+    qint32 last = blocks.first().lastDay;
+    foreach (const Block &block, blocks)
+        last = qMax(last, block.lastDay);
+    return QDate::fromJulianDay(last);
+}
+
+int MenuArchive::append(const QVector<MenuDay> &days) {
+    if (!isOpen())
+        return 0;
+
+    QMap<qint32, MenuDay> incoming;
+    foreach (const MenuDay &day, days) {
+        if (day.date.isValid())
+            incoming.insert(qint32(day.date.toJulianDay()), day);
+    }
+    if (incoming.isEmpty())
+        return 0;
+
+    // sama ruokalista tulee joka päivityksellä, vain muutokset tallennetaan
+    QVector<MenuDay> archived = range(QDate::fromJulianDay(incoming.firstKey()), QDate::fromJulianDay(incoming.lastKey()));
+    foreach (const MenuDay &day, archived) {
+        QMap<qint32, MenuDay>::iterator it = incoming.find(qint32(day.date.toJulianDay()));
+        if (it != incoming.end() && sameDay(it.value(), day))
+            incoming.erase(it);
+    }
+    if (incoming.isEmpty())
+        return 0;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    QMap<qint32, MenuDay>::const_iterator it;
+    for (it = incoming.constBegin(); it != incoming.constEnd(); ++it) {
+        out << it.key() << it.value().name;
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            out << it.value().meals[slot];
+    }
+    QByteArray compressed = qCompress(payload, 9);
+
+    BlockHeader header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.size = compressed.size();
+    header.firstDay = incoming.firstKey();
+    header.lastDay = incoming.lastKey();
+    header.dayCount = incoming.count();
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "menu archive: cannot write" << fileName << file.errorString();
+        return 0;
+    }
+    // keskeneräinen lohko edellisestä kaatumisesta pois
+    if (file.size() != validSize)
+        file.resize(validSize);
+    file.seek(validSize);
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))
+            || file.write(compressed) != compressed.size() || !file.flush()) {
+        qWarning() << "menu archive: cannot write" << fileName << file.errorString();
+        return 0;
+    }
+
+    Block block;
+    block.offset = validSize;
+    block.size = header.size;
+    block.firstDay = header.firstDay;
+    block.lastDay = header.lastDay;
+    blocks.append(block);
+    validSize += sizeof(header) + header.size;
+    return header.dayCount;
+}
+
+QVector<MenuDay> MenuArchive::range(const QDate &from, const QDate &to) const {
+    QVector<MenuDay> result;
+    if (!isOpen() || blocks.isEmpty())
+        return result;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return result;
+
+    qint64 first = from.isValid() ? from.toJulianDay() : Q_INT64_C(-0x7fffffffffffffff);
+    qint64 last = to.isValid() ? to.toJulianDay() : Q_INT64_C(0x7fffffffffffffff);
+
+    // myöhempi lohko korvaa aiemman saman päivän
+    QMap<qint32, MenuDay> days;
+    foreach (const Block &block, blocks) {
+        if (block.lastDay < first || block.firstDay > last)
+            continue;
+        file.seek(block.offset + sizeof(BlockHeader));
+        QByteArray payload = qUncompress(file.read(block.size));
+
+        QDataStream in(payload);
+        in.setVersion(QDataStream::Qt_5_0);
+        while (!in.atEnd()) {
+            qint32 julianDay;
+            MenuDay day;
+            in >> julianDay >> day.name;
+            for (int slot = 0; slot < MealSlotCount; ++slot)
+                in >> day.meals[slot];
+            if (in.status() != QDataStream::Ok)
+                break;
+            if (julianDay < first || julianDay > last)
+                continue;
+            day.date = QDate::fromJulianDay(julianDay);
+            days.insert(julianDay, day);
+        }
+    }
+
+    result.reserve(days.count());
+    QMap<qint32, MenuDay>::const_iterator it;
+    for (it = days.constBegin(); it != days.constEnd(); ++it)
+        result.append(it.value());
+    return result;
+}
@@ -0,0 +1,79 @@
+#ifndef MENUARCHIVE_H
+#define MENUARCHIVE_H
+
+#include <QString>
+#include <QVector>
+#include <QDate>
+#include "menuday.h"
+
+// Every menu the feeds have ever published, kept after the feed has moved
+// on. The file is a sequence of blocks that are only ever appended:
+//
+//   block header (date range, compressed size) | qCompress'd days
+//
+// open() reads just the block headers into a sparse date index, so a
+// range query decompresses only the blocks whose dates overlap it. A day
+// may appear in several blocks when the menu was corrected; the newest
+// block wins. append() writes only days that are new or changed.
+class MenuArchive
+{
+public:
+    MenuArchive();
+
+    bool open(const QString &fileName);
+
+    inline bool isOpen() const {
+        return !fileName.isEmpty();
+    }
+
+    inline int blockCount() const {
+        return blocks.count();
+    }
+
+    // lohkon ensimmäinen ja viimeinen päivä, lohkot kirjoitusjärjestyksessä
+    inline QDate blockFirstDate(int block) const {
+        return QDate::fromJulianDay(blocks.at(block).firstDay);
+    }
+    inline QDate blockLastDate(int block) const {
+        return QDate::fromJulianDay(blocks.at(block).lastDay);
+    }
+
+    inline const QString &getFileName() const {
+        return fileName;
+    }
+
+    // arkiston päivät firstDate()..lastDate(), tyhjä jos arkisto on tyhjä
+    QDate firstDate() const;
+    QDate lastDate() const;
+
+    // palauttaa kirjoitettujen päivien määrän
+    int append(const QVector<MenuDay> &days);
+
+    // päivät järjestyksessä, tyhjä päivämäärä jättää rajan auki
+    QVector<MenuDay> range(const QDate &from = QDate(), const QDate &to = QDate()) const;
+
+    static QString defaultFileName();
+
+private:
+    struct BlockHeader {
+        char magic[4];
+        quint32 version;
+        quint32 size;
+        qint32 firstDay;
+        qint32 lastDay;
+        quint32 dayCount;
+    };
+
+    struct Block {
+        qint64 offset;
+        quint32 size;
+        qint32 firstDay;
+        qint32 lastDay;
+    };
+
+    QString fileName;
+    QVector<Block> blocks;
+    qint64 validSize;
+};
+
+#endif // MENUARCHIVE_H
@@ -0,0 +1,54 @@
+#include "menucache.h"
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+MenuCache::MenuCache(const QUrl &source)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/menus";
+    QByteArray key = QCryptographicHash::hash(source.toEncoded(), QCryptographicHash::Sha1).toHex();
+    basePath = dir + '/' + QString::fromLatin1(key);
+}
+
+bool MenuCache::load() {
+    snapshot.reset(new MenuSnapshot);
+    // vanhemmat versiot tallensivat myös tyhjän listan, sitä ei näytetä
+    if (!snapshot->open(basePath + ".menu") || snapshot->dayCount() == 0) {
+        snapshot.reset();
+        return false;
+    }
+
+    // validaattorit: ETag ja Last-Modified omilla riveillään
+    QFile meta(basePath + ".meta");
+    if (meta.open(QIODevice::ReadOnly)) {
+        etag = meta.readLine().trimmed();
+        lastModified = meta.readLine().trimmed();
+    }
+    return true;
+}
+
+bool MenuCache::store(const QVector<MenuEntry> &days, const DishPool &pool,
+                      const QByteArray &newEtag, const QByteArray &newLastModified) {
+    QDir().mkpath(basePath.left(basePath.lastIndexOf('/')));
+
+    if (!MenuSnapshot::write(basePath + ".menu", days, pool))
+        return false;
+    // vanha XML-muotoinen välimuisti
+    QFile::remove(basePath + ".xml");
+
+    QSaveFile meta(basePath + ".meta");
+    if (!meta.open(QIODevice::WriteOnly)) {
+        qDebug() << "menu cache: cannot write" << meta.fileName() << meta.errorString();
+        return false;
+    }
+    meta.write(newEtag + '\n' + newLastModified + '\n');
+    if (!meta.commit())
+        return false;
+
+    etag = newEtag;
+    lastModified = newLastModified;
+    return true;
+}
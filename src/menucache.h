@@ -0,0 +1,44 @@
+#ifndef MENUCACHE_H
+#define MENUCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+#include <QScopedPointer>
+#include "menuday.h"
+#include "menusnapshot.h"
+
+// Last successfully downloaded menu of one feed together with the HTTP
+// validators needed to revalidate it. The menu itself is kept as a mapped
+// MenuSnapshot so that startup does not have to parse any XML.
+class MenuCache
+{
+public:
+    explicit MenuCache(const QUrl &source);
+
+    bool load();
+    bool store(const QVector<MenuEntry> &days, const DishPool &pool,
+               const QByteArray &etag, const QByteArray &lastModified);
+
+    // omistus siirtyy kutsujalle
+    inline MenuSnapshot *takeSnapshot() {
+        return snapshot.take();
+    }
+
+    inline const QByteArray &getETag() const {
+        return etag;
+    }
+
+    inline const QByteArray &getLastModified() const {
+        return lastModified;
+    }
+
+private:
+    QString basePath;
+    QScopedPointer<MenuSnapshot> snapshot;
+    QByteArray etag;
+    QByteArray lastModified;
+};
+
+#endif // MENUCACHE_H
@@ -0,0 +1,35 @@
+#ifndef MENUDAY_H
+#define MENUDAY_H
+
+#include <QDate>
+#include <QString>
+#include <QMetaType>
+
+enum MealSlot {
+    Breakfast,
+    Lunch,
+    Dinner,
+    Supper,
+    MealSlotCount
+};
+
+// One <day> of food.xml
+struct MenuDay
+{
+    QDate date;
+    QString name;
+    QString meals[MealSlotCount];
+};
+
+// The same day once its texts have been interned into a DishPool
+struct MenuEntry
+{
+    QDate date;
+    quint32 name;
+    quint32 meals[MealSlotCount];
+};
+
+Q_DECLARE_TYPEINFO(MenuEntry, Q_MOVABLE_TYPE);
+Q_DECLARE_METATYPE(MenuDay)
+
+#endif // MENUDAY_H
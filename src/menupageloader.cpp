@@ -0,0 +1,15 @@
+#include "menupageloader.h"
+
+MenuPageLoader::MenuPageLoader(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void MenuPageLoader::reopen(const QString &fileName) {
+    archive.open(fileName);
+}
+
+void MenuPageLoader::load(qint64 weekStart) {
+    QDate monday = QDate::fromJulianDay(weekStart);
+    emit loaded(weekStart, archive.range(monday, monday.addDays(6)));
+}
@@ -0,0 +1,29 @@
+#ifndef MENUPAGELOADER_H
+#define MENUPAGELOADER_H
+
+#include <QObject>
+#include <QVector>
+#include "menuday.h"
+#include "menuarchive.h"
+
+// Reads whole weeks out of the menu archive in a background thread. Keeps
+// its own MenuArchive on the same file so the GUI thread's copy is never
+// touched from here; reopen() rescans it after new blocks were appended.
+class MenuPageLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MenuPageLoader(QObject *parent = 0);
+
+public slots:
+    void reopen(const QString &fileName);
+    void load(qint64 weekStart);
+
+signals:
+    void loaded(qint64 weekStart, const QVector<MenuDay> &days);
+
+private:
+    MenuArchive archive;
+};
+
+#endif // MENUPAGELOADER_H
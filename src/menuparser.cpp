@@ -0,0 +1,85 @@
+#include "menuparser.h"
+
+static const char *const slotElements[MealSlotCount] = {
+    "breakfast",
+    "lunch",
+    "dinner",
+    "supper"
+};
+
+MenuParser::MenuParser() :
+    slot(-1), inDay(false), finished(false)
+{
+    QDate today = QDate::currentDate();
+    weekStart = today.addDays(1 - today.dayOfWeek());
+}
+
+const char *MenuParser::slotElement(MealSlot slot) {
+    return slotElements[slot];
+}
+
+void MenuParser::setWeekStart(const QDate &monday) {
+    weekStart = monday;
+}
+
+void MenuParser::addData(const QByteArray &data) {
+    xml.addData(data);
+}
+
+bool MenuParser::parse() {
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (xml.name() == QLatin1String("day")) {
+                inDay = true;
+                slot = -1;
+                current = MenuDay();
+                current.name = xml.attributes().value(QLatin1String("name")).toString();
+                bool ok;
+                int weekday = current.name.toInt(&ok);
+                if (ok && weekday >= 1 && weekday <= 7)
+                    current.date = weekStart.addDays(weekday - 1);
+            } else if (inDay) {
+                slot = -1;
+                for (int i = 0; i < MealSlotCount; ++i) {
+                    if (xml.name() == QLatin1String(slotElements[i])) {
+                        slot = i;
+                        text.clear();
+                        break;
+                    }
+                }
+            } else if (xml.name() == QLatin1String("week")) {
+                QDate start = QDate::fromString(xml.attributes().value(QLatin1String("start")).toString(), Qt::ISODate);
+                if (start.isValid())
+                    weekStart = start;
+            }
+            break;
+        case QXmlStreamReader::Characters:
+            if (inDay && slot >= 0)
+                text += xml.text();
+            break;
+        case QXmlStreamReader::EndElement:
+            if (xml.name() == QLatin1String("day")) {
+                days.append(current);
+                inDay = false;
+            } else if (inDay && slot >= 0) {
+                current.meals[slot] = text.trimmed();
+                slot = -1;
+            }
+            break;
+        case QXmlStreamReader::EndDocument:
+            finished = true;
+            break;
+        default:
+            break;
+        }
+    }
+    // kesken jäänyt dokumentti jatkuu seuraavasta palasta
+    return !xml.hasError() || xml.error() == QXmlStreamReader::PrematureEndOfDocumentError;
+}
+
+QVector<MenuDay> MenuParser::takeDays() {
+    QVector<MenuDay> result;
+    result.swap(days);
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef MENUPARSER_H
+#define MENUPARSER_H
+
+#include <QXmlStreamReader>
+#include <QVector>
+#include "menuday.h"
+
+// Single pass reader for the food.xml /week/day schema:
+//
+//   <week start="2014-03-03">
+//     <day name="1"><breakfast>..</breakfast><lunch>..</lunch>..</day>
+//   </week>
+//
+// Data can be added in pieces; parse() consumes whatever is available and
+// collects every <day> that has been closed so far.
+class MenuParser
+{
+public:
+    MenuParser();
+
+    // viikon maanantai, jos <week> ei kerro sitä itse
+    void setWeekStart(const QDate &monday);
+
+    void addData(const QByteArray &data);
+    bool parse();
+
+    QVector<MenuDay> takeDays();
+
+    inline bool isFinished() const {
+        return finished;
+    }
+
+    inline QString errorString() const {
+        return xml.errorString();
+    }
+
+    static const char *slotElement(MealSlot slot);
+
+private:
+    QXmlStreamReader xml;
+    QDate weekStart;
+    QVector<MenuDay> days;
+    MenuDay current;
+    QString text;
+    int slot;
+    bool inDay;
+    bool finished;
+};
+
+#endif // MENUPARSER_H
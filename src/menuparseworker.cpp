@@ -0,0 +1,64 @@
+#include "menuparseworker.h"
+#include "menuparser.h"
+#include "menuarchive.h"
+
+MenuParseWorker::MenuParseWorker(QObject *parent) :
+    QObject(parent), generation(-1)
+{
+}
+
+MenuParseWorker::~MenuParseWorker() {
+    qDeleteAll(parsers);
+}
+
+void MenuParseWorker::addData(int loadGeneration, int feed, const QByteArray &data) {
+    MenuParser *parser = parserFor(loadGeneration, feed);
+    if (!parser)
+        return;
+    parser->addData(data);
+    bool ok = parser->parse();
+    QVector<MenuDay> days = parser->takeDays();
+    if (!days.isEmpty())
+        emit parsed(loadGeneration, feed, days);
+    if (!ok) {
+        emit finished(loadGeneration, feed, false, parser->errorString());
+        delete parsers.take(feed);
+    }
+}
+
+void MenuParseWorker::finish(int loadGeneration, int feed) {
+    MenuParser *parser = parserFor(loadGeneration, feed);
+    if (!parser)
+        return;
+    bool ok = parser->parse();
+    QVector<MenuDay> days = parser->takeDays();
+    if (!days.isEmpty())
+        emit parsed(loadGeneration, feed, days);
+    emit finished(loadGeneration, feed, ok && parser->isFinished(), parser->errorString());
+    delete parsers.take(feed);
+}
+
+void MenuParseWorker::indexArchive(const QString &fileName) {
+    MenuArchive archive;
+    DishIndex index;
+    if (archive.open(fileName)) {
+        foreach (const MenuDay &menu, archive.range())
+            index.addDay(menu.date, menu.meals);
+    }
+    if (index.dayCount() > 0)
+        emit archiveIndexed(index);
+}
+
+MenuParser *MenuParseWorker::parserFor(int loadGeneration, int feed) {
+    if (loadGeneration < generation)
+        return 0;
+    if (loadGeneration > generation) {
+        qDeleteAll(parsers);
+        parsers.clear();
+        generation = loadGeneration;
+    }
+    MenuParser *&parser = parsers[feed];
+    if (!parser)
+        parser = new MenuParser;
+    return parser;
+}
@@ -0,0 +1,40 @@
+#ifndef MENUPARSEWORKER_H
+#define MENUPARSEWORKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include "menuday.h"
+#include "dishindex.h"
+
+class MenuParser;
+
+// Runs the MenuParsers of every feed in the parser thread. Calls carry the
+// load generation of QFoodCalendar; parsers of an older load are dropped as
+// soon as data of a newer one arrives. The menu archive is also indexed
+// here at startup, so its blocks are never decompressed on the GUI thread.
+class MenuParseWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MenuParseWorker(QObject *parent = 0);
+    ~MenuParseWorker();
+
+public slots:
+    void addData(int generation, int feed, const QByteArray &data);
+    void finish(int generation, int feed);
+    void indexArchive(const QString &fileName);
+
+signals:
+    void parsed(int generation, int feed, const QVector<MenuDay> &days);
+    void finished(int generation, int feed, bool ok, const QString &error);
+    void archiveIndexed(const DishIndex &index);
+
+private:
+    MenuParser *parserFor(int generation, int feed);
+
+    int generation;
+    QHash<int, MenuParser *> parsers;
+};
+
+#endif // MENUPARSEWORKER_H
@@ -0,0 +1,127 @@
+#include "menusnapshot.h"
+#include <QSaveFile>
+#include <QDebug>
+#include <string.h>
+
+static const char Magic[4] = { 'S', 'M', 'M', 'S' };
+static const quint32 Version = 1;
+
+MenuSnapshot::MenuSnapshot() :
+    map(0), header(0), records(0), pool(0)
+{
+}
+
+MenuSnapshot::~MenuSnapshot() {
+    if (map)
+        file.unmap(const_cast<uchar *>(map));
+}
+
+bool MenuSnapshot::open(const QString &fileName) {
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    qint64 size = file.size();
+    if (size < qint64(sizeof(Header)))
+        return false;
+    map = file.map(0, size);
+    if (!map)
+        return false;
+
+    const Header *h = reinterpret_cast<const Header *>(map);
+    quint64 tableEnd = sizeof(Header) + quint64(h->dayCount) * sizeof(DayRecord);
+    if (memcmp(h->magic, Magic, sizeof(Magic)) != 0 || h->version != Version
+            || tableEnd > h->poolOffset || quint64(h->poolOffset) + h->poolSize > quint64(size)) {
+        qDebug() << "menu snapshot: ignoring incompatible" << fileName;
+        return false;
+    }
+
+    header = h;
+    records = reinterpret_cast<const DayRecord *>(map + sizeof(Header));
+    pool = map + header->poolOffset;
+    return true;
+}
+
+QDate MenuSnapshot::date(int day) const {
+    if (day < 0 || day >= dayCount())
+        return QDate();
+    qint32 julianDay = records[day].julianDay;
+    return julianDay ? QDate::fromJulianDay(julianDay) : QDate();
+}
+
+QString MenuSnapshot::name(int day) const {
+    if (day < 0 || day >= dayCount())
+        return QString();
+    return string(records[day].name);
+}
+
+QString MenuSnapshot::meal(int day, int slot) const {
+    if (day < 0 || day >= dayCount() || slot < 0 || slot >= MealSlotCount)
+        return QString();
+    return string(records[day].meals[slot]);
+}
+
+// kopioidaan vain pyydetty merkkijono, jotta QML ei jää viittaamaan mappaukseen
+QString MenuSnapshot::string(quint32 offset) const {
+    // 64-bittisenä, ettei rikkinäinen offset kierrä ympäri 32-bittisellä size_t:llä
+    quint64 start = quint64(offset) + sizeof(quint32);
+    if (start > header->poolSize)
+        return QString();
+    quint32 length;
+    memcpy(&length, pool + offset, sizeof(length));
+    if (start + quint64(length) * sizeof(QChar) > header->poolSize)
+        return QString();
+    return QString(reinterpret_cast<const QChar *>(pool + offset + sizeof(quint32)), length);
+}
+
+bool MenuSnapshot::write(const QString &fileName, const QVector<MenuEntry> &days, const DishPool &pool) {
+    QByteArray stringPool;
+    // poolin id -> tiedoston offset, vain käytetyt merkkijonot kirjoitetaan
+    QVector<quint32> offsets(pool.count(), quint32(-1));
+    QVector<DayRecord> table(days.count());
+
+    for (int i = 0; i < days.count(); ++i) {
+        const MenuEntry &day = days.at(i);
+        DayRecord &record = table[i];
+        record.julianDay = day.date.isValid() ? qint32(day.date.toJulianDay()) : 0;
+
+        quint32 ids[MealSlotCount + 1] = { day.name };
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            ids[slot + 1] = day.meals[slot];
+
+        for (int t = 0; t <= MealSlotCount; ++t) {
+            quint32 &offset = offsets[ids[t]];
+            if (offset == quint32(-1)) {
+                const QString &text = pool.text(ids[t]);
+                offset = stringPool.size();
+                quint32 length = text.size();
+                stringPool.append(reinterpret_cast<const char *>(&length), sizeof(length));
+                stringPool.append(reinterpret_cast<const char *>(text.constData()), length * sizeof(QChar));
+                // seuraava merkkijono 4 tavun rajalle
+                while (stringPool.size() % 4)
+                    stringPool.append('\0');
+            }
+            if (t == 0)
+                record.name = offset;
+            else
+                record.meals[t - 1] = offset;
+        }
+    }
+
+    Header h;
+    memcpy(h.magic, Magic, sizeof(Magic));
+    h.version = Version;
+    h.dayCount = days.count();
+    h.poolOffset = sizeof(Header) + days.count() * sizeof(DayRecord);
+    h.poolSize = stringPool.size();
+
+    QSaveFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qDebug() << "menu snapshot: cannot write" << fileName << out.errorString();
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char *>(table.constData()), table.count() * sizeof(DayRecord));
+    out.write(stringPool);
+    return out.commit();
+}
@@ -0,0 +1,58 @@
+#ifndef MENUSNAPSHOT_H
+#define MENUSNAPSHOT_H
+
+#include <QFile>
+#include <QVector>
+#include "menuday.h"
+#include "dishpool.h"
+
+// Parsed menu persisted as a compact binary file:
+//
+//   header | day table | string pool
+//
+// Every day record stores its date and the pool offsets of its name and
+// meal texts. Pool entries are a quint32 length followed by UTF-16 data,
+// each distinct DishPool string is written once. The file is mapped and read in
+// place; nothing is deserialized up front.
+class MenuSnapshot
+{
+public:
+    MenuSnapshot();
+    ~MenuSnapshot();
+
+    bool open(const QString &fileName);
+    static bool write(const QString &fileName, const QVector<MenuEntry> &days, const DishPool &pool);
+
+    inline int dayCount() const {
+        return header ? int(header->dayCount) : 0;
+    }
+
+    QDate date(int day) const;
+    QString name(int day) const;
+    QString meal(int day, int slot) const;
+
+private:
+    struct Header {
+        char magic[4];
+        quint32 version;
+        quint32 dayCount;
+        quint32 poolOffset;
+        quint32 poolSize;
+    };
+
+    struct DayRecord {
+        qint32 julianDay;
+        quint32 name;
+        quint32 meals[MealSlotCount];
+    };
+
+    QString string(quint32 offset) const;
+
+    QFile file;
+    const uchar *map;
+    const Header *header;
+    const DayRecord *records;
+    const uchar *pool;
+};
+
+#endif // MENUSNAPSHOT_H
@@ -0,0 +1,123 @@
+#include "orderstatistictree.h"
+
+OrderStatisticTree::OrderStatisticTree() :
+    root(-1), seed(2463534242u)
+{
+}
+
+void OrderStatisticTree::insert(qint64 key) {
+    int node;
+    if (!freeNodes.isEmpty()) {
+        node = freeNodes.takeLast();
+    } else {
+        node = nodes.count();
+        nodes.append(Node());
+    }
+    Node &n = nodes[node];
+    n.key = key;
+    n.priority = nextPriority();
+    n.left = -1;
+    n.right = -1;
+    n.size = 1;
+
+    int left, right;
+    split(root, key, left, right);
+    root = merge(merge(left, node), right);
+}
+
+void OrderStatisticTree::remove(qint64 key) {
+    int left, middle, right;
+    split(root, key, left, right);
+    split(right, key + 1, middle, right);
+    if (middle >= 0)
+        freeNodes.append(middle);
+    root = merge(left, right);
+}
+
+void OrderStatisticTree::clear() {
+    nodes.clear();
+    freeNodes.clear();
+    root = -1;
+}
+
+int OrderStatisticTree::countLess(qint64 key) const {
+    int result = 0;
+    int node = root;
+    while (node >= 0) {
+        const Node &n = nodes.at(node);
+        if (key <= n.key) {
+            node = n.left;
+        } else {
+            result += sizeOf(n.left) + 1;
+            node = n.right;
+        }
+    }
+    return result;
+}
+
+qint64 OrderStatisticTree::select(int i) const {
+    int node = root;
+    while (node >= 0) {
+        const Node &n = nodes.at(node);
+        int leftSize = sizeOf(n.left);
+        if (i < leftSize) {
+            node = n.left;
+        } else if (i == leftSize) {
+            return n.key;
+        } else {
+            i -= leftSize + 1;
+            node = n.right;
+        }
+    }
+    return -1;
+}
+
+void OrderStatisticTree::update(int node) {
+    Node &n = nodes[node];
+    n.size = sizeOf(n.left) + sizeOf(n.right) + 1;
+}
+
+// left saa avaimet < key, right avaimet >= key
+void OrderStatisticTree::split(int node, qint64 key, int &left, int &right) {
+    if (node < 0) {
+        left = right = -1;
+        return;
+    }
+    if (nodes.at(node).key < key) {
+        int r;
+        split(nodes.at(node).right, key, r, right);
+        nodes[node].right = r;
+        left = node;
+    } else {
+        int l;
+        split(nodes.at(node).left, key, left, l);
+        nodes[node].left = l;
+        right = node;
+    }
+    update(node);
+}
+
+int OrderStatisticTree::merge(int left, int right) {
+    if (left < 0)
+        return right;
+    if (right < 0)
+        return left;
+    if (nodes.at(left).priority > nodes.at(right).priority) {
+        int r = merge(nodes.at(left).right, right);
+        nodes[left].right = r;
+        update(left);
+        return left;
+    }
+    int l = merge(left, nodes.at(right).left);
+    nodes[right].left = l;
+    update(right);
+    return right;
+}
+
+// xorshift riittää tasapainottamiseen
+quint32 OrderStatisticTree::nextPriority() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
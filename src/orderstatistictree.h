@@ -0,0 +1,54 @@
+#ifndef ORDERSTATISTICTREE_H
+#define ORDERSTATISTICTREE_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// Treap of unique qint64 keys where every node knows its subtree size, so
+// that insert, remove, rank and select all run in O(log n). Nodes live in
+// one vector and are linked by index, freed slots are reused.
+class OrderStatisticTree
+{
+public:
+    OrderStatisticTree();
+
+    inline int count() const {
+        return root < 0 ? 0 : nodes.at(root).size;
+    }
+
+    void insert(qint64 key);
+    void remove(qint64 key);
+    void clear();
+
+    // number of keys smaller than key
+    int countLess(qint64 key) const;
+    // key at position i in ascending order
+    qint64 select(int i) const;
+
+private:
+    struct Node {
+        qint64 key;
+        quint32 priority;
+        int left;
+        int right;
+        int size;
+    };
+
+    inline int sizeOf(int node) const {
+        return node < 0 ? 0 : nodes.at(node).size;
+    }
+
+    void update(int node);
+    void split(int node, qint64 key, int &left, int &right);
+    int merge(int left, int right);
+    quint32 nextPriority();
+
+    QVector<Node> nodes;
+    QVector<int> freeNodes;
+    int root;
+    quint32 seed;
+};
+
+Q_DECLARE_TYPEINFO(OrderStatisticTree, Q_MOVABLE_TYPE);
+
+#endif // ORDERSTATISTICTREE_H
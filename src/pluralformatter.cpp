@@ -0,0 +1,70 @@
+#include "pluralformatter.h"
+#include <qmath.h>
+
+struct PluralFormatter::Table {
+    QLocale::Language language;
+    char decimalPoint;
+    // UTF-8, yksikkö ja monikko (partitiivi)
+    const char *words[UnitCount][2];
+};
+
+static const PluralFormatter::Table tables[] = {
+    { QLocale::Finnish, ',', {
+        { "aamu", "aamua" },
+        { "päivä", "päivää" },
+        { "viikko", "viikkoa" },
+        { "kuukausi", "kuukautta" },
+        { "tunti", "tuntia" } } },
+    { QLocale::English, '.', {
+        { "morning", "mornings" },
+        { "day", "days" },
+        { "week", "weeks" },
+        { "month", "months" },
+        { "hour", "hours" } } }
+};
+
+static const int tableCount = sizeof(tables) / sizeof(tables[0]);
+
+PluralFormatter::PluralFormatter(QLocale::Language language) :
+    table(&tables[0])
+{
+    for (int i = 0; i < tableCount; ++i) {
+        if (tables[i].language == language) {
+            table = &tables[i];
+            break;
+        }
+    }
+}
+
+void PluralFormatter::format(QString &out, qreal value, Unit unit, int decimals) const {
+    out.resize(0);
+
+    qint64 scale = 1;
+    for (int i = 0; i < decimals; ++i)
+        scale *= 10;
+    qint64 scaled = qRound64(qAbs(value) * scale);
+    qint64 whole = scaled / scale;
+    qint64 fraction = scaled % scale;
+
+    if (value < 0 && scaled != 0)
+        out += QLatin1Char('-');
+    out += QString::number(whole);
+    // tasaluvuista ei näytetä desimaaleja, "2 viikkoa" eikä "2,0 viikkoa"
+    if (fraction != 0) {
+        out += QLatin1Char(table->decimalPoint);
+        for (qint64 digit = scale / 10; digit > 0; digit /= 10) {
+            out += QLatin1Char(char('0' + fraction / digit));
+            fraction %= digit;
+        }
+    }
+
+    bool singular = scaled == scale;
+    out += QLatin1Char(' ');
+    out += QString::fromUtf8(table->words[unit][singular ? 0 : 1]);
+}
+
+QString PluralFormatter::format(qreal value, Unit unit, int decimals) const {
+    QString out;
+    format(out, value, unit, decimals);
+    return out;
+}
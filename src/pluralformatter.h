@@ -0,0 +1,36 @@
+#ifndef PLURALFORMATTER_H
+#define PLURALFORMATTER_H
+
+#include <QString>
+#include <QLocale>
+
+// "1 aamu", "2,5 kuukautta" and so on. Unit words come from a static table
+// per language. The singular is picked from the value as printed: whole
+// numbers drop their decimals, so 0.96 months rounds to "1 kuukausi".
+// format() can also write into a string the caller already has.
+class PluralFormatter
+{
+public:
+    enum Unit {
+        Morning,
+        Day,
+        Week,
+        Month,
+        Hour,
+        UnitCount
+    };
+
+    // sovellus on suomeksi, muut kielet vain jos ne pyydetään
+    explicit PluralFormatter(QLocale::Language language = QLocale::Finnish);
+
+    // tyhjentää out:n ja kirjoittaa siihen, varattu tila säilyy
+    void format(QString &out, qreal value, Unit unit, int decimals = 0) const;
+    QString format(qreal value, Unit unit, int decimals = 0) const;
+
+    struct Table;
+
+private:
+    const Table *table;
+};
+
+#endif // PLURALFORMATTER_H
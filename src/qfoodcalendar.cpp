@@ -1,6 +1,665 @@
 #include "qfoodcalendar.h"
+#include "menucache.h"
+#include "menuparseworker.h"
+#include "wakeupscheduler.h"
+#include "mealconfig.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
 
 QFoodCalendar::QFoodCalendar(QObject *parent) :
-    QObject(parent)
+    QAbstractListModel(parent), network(new QNetworkAccessManager(this)), parseWorker(new MenuParseWorker),
+    inFlight(0), generation(0), failures(0), archivePending(false), day(0), status(Null), mealConfig(0), active(true)
 {
+    qRegisterMetaType<QVector<MenuDay> >("QVector<MenuDay>");
+    qRegisterMetaType<DishIndex>("DishIndex");
+    parseWorker->moveToThread(&parserThread);
+    connect(parseWorker, SIGNAL(parsed(int,int,QVector<MenuDay>)), this, SLOT(daysParsed(int,int,QVector<MenuDay>)));
+    connect(parseWorker, SIGNAL(finished(int,int,bool,QString)), this, SLOT(parseFinished(int,int,bool,QString)));
+    connect(parseWorker, SIGNAL(archiveIndexed(DishIndex)), this, SLOT(archiveIndexed(DishIndex)));
+    parserThread.setObjectName("menuparser");
+    parserThread.start(QThread::LowPriority);
+
+    // vain lohkojen otsikot luetaan täällä, vanhat ruokalistat indeksoidaan
+    // parserisäikeessä käynnistyksen jälkeen
+    if (archive.open(MenuArchive::defaultFileName()))
+        QMetaObject::invokeMethod(parseWorker, "indexArchive", Qt::QueuedConnection,
+                                  Q_ARG(QString, archive.getFileName()));
+    updateMeals();
+}
+
+QFoodCalendar::~QFoodCalendar() {
+    abortRequests();
+    parserThread.quit();
+    parserThread.wait();
+    delete parseWorker;
+    qDeleteAll(feeds);
+}
+
+QUrl QFoodCalendar::getSource() const {
+    return sources.isEmpty() ? QUrl() : QUrl(sources.first());
+}
+
+void QFoodCalendar::setSource(const QUrl &url) {
+    setSources(url.isEmpty() ? QStringList() : QStringList() << url.toString());
+}
+
+void QFoodCalendar::setSources(const QStringList &urls) {
+    if (urls == sources)
+        return;
+    QUrl previousSource = getSource();
+    sources = urls;
+    emit sourcesChanged();
+    if (getSource() != previousSource)
+        emit sourceChanged();
+    reload();
+}
+
+void QFoodCalendar::setDay(int value) {
+    if (value == day)
+        return;
+    day = value;
+    updateRows();
+    emit dayChanged();
+}
+
+void QFoodCalendar::setMealConfig(MealConfig *config) {
+    mealConfig = config;
+    connect(mealConfig, SIGNAL(scheduleChanged()), this, SLOT(mealScheduleChanged()));
+    mealScheduleChanged();
+}
+
+void QFoodCalendar::mealScheduleChanged() {
+    mealIndex.setSchedule(mealConfig->getSchedule());
+    updateMeals();
+    emit mealIndexChanged();
+}
+
+int QFoodCalendar::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.count();
+}
+
+QVariant QFoodCalendar::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows.count())
+        return QVariant();
+
+    const DayRef &ref = rows.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return dayName(ref);
+    case DateRole:
+        return dayDate(ref);
+    case BreakfastRole:
+    case LunchRole:
+    case DinnerRole:
+    case SupperRole:
+        return mealText(ref, role - BreakfastRole);
+    case SourceRole:
+        return feeds.at(ref.feed)->url.toString();
+    case ChangedRole:
+        return isChanged(ref);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> QFoodCalendar::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[DateRole] = "date";
+    roles[BreakfastRole] = MenuParser::slotElement(Breakfast);
+    roles[LunchRole] = MenuParser::slotElement(Lunch);
+    roles[DinnerRole] = MenuParser::slotElement(Dinner);
+    roles[SupperRole] = MenuParser::slotElement(Supper);
+    roles[SourceRole] = "source";
+    roles[ChangedRole] = "changed";
+    return roles;
+}
+
+void QFoodCalendar::reload() {
+    abortRequests();
+    // vanhan latauksen parsitut päivät hylätään kun ne tulevat perille
+    ++generation;
+    failures = 0;
+    lastError.clear();
+
+    if (sameFeeds()) {
+        // samat syötteet: nykyinen sisältö jää näkyviin ja päivittyy erotuksella
+        foreach (Feed *feed, feeds) {
+            feed->pending.clear();
+            feed->done = false;
+        }
+    } else {
+        int previousCount = rows.count();
+        beginResetModel();
+        qDeleteAll(feeds);
+        feeds.clear();
+        foreach (const QString &url, sources) {
+            Feed *feed = new Feed;
+            feed->url = QUrl(url);
+            MenuCache cache(feed->url);
+            if (cache.load()) {
+                feed->snapshot.reset(cache.takeSnapshot());
+                feed->etag = cache.getETag();
+                feed->lastModified = cache.getLastModified();
+            }
+            feeds.append(feed);
+        }
+        rebuildRows();
+        endResetModel();
+        if (rows.count() != previousCount)
+            emit countChanged();
+        indexDays();
+    }
+
+    if (feeds.isEmpty()) {
+        setStatus(Null);
+        return;
+    }
+    setStatus(rows.isEmpty() ? Loading : Ready);
+
+    for (int i = 0; i < feeds.count(); ++i)
+        queue.append(i);
+    startRequests();
+}
+
+void QFoodCalendar::markSeen() {
+    foreach (Feed *feed, feeds)
+        feed->changed.fill(false);
+    if (!rows.isEmpty())
+        emit dataChanged(index(0), index(rows.count() - 1), QVector<int>() << ChangedRole);
+}
+
+// korkeintaan MaxRequests pyyntöä kerrallaan, loput jonossa
+void QFoodCalendar::startRequests() {
+    while (inFlight < MaxRequests && !queue.isEmpty()) {
+        int index = queue.takeFirst();
+        Feed *feed = feeds.at(index);
+        // näkyvissä oleva sisältö vaihtuu vasta kun uusi lista on kokonainen.
+        // Tyhjäkin välimuisti korvataan, muuten päivät menisivät days-
+        // taulukkoon mutta niitä luettaisiin yhä mappauksesta.
+        feed->replacing = feed->snapshot || !feed->days.isEmpty();
+        QNetworkRequest request(feed->url);
+        if (feed->replacing) {
+            if (!feed->etag.isEmpty())
+                request.setRawHeader("If-None-Match", feed->etag);
+            if (!feed->lastModified.isEmpty())
+                request.setRawHeader("If-Modified-Since", feed->lastModified);
+        }
+        feed->reply = network->get(request);
+        connect(feed->reply, SIGNAL(readyRead()), this, SLOT(replyReadyRead()));
+        connect(feed->reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+        ++inFlight;
+    }
+}
+
+void QFoodCalendar::abortRequests() {
+    foreach (Feed *feed, feeds) {
+        if (!feed->reply)
+            continue;
+        feed->reply->disconnect(this);
+        feed->reply->abort();
+        feed->reply->deleteLater();
+        feed->reply = 0;
+    }
+    queue.clear();
+    inFlight = 0;
+}
+
+int QFoodCalendar::feedOf(QObject *reply) const {
+    for (int i = 0; i < feeds.count(); ++i) {
+        if (feeds.at(i)->reply == reply)
+            return i;
+    }
+    return -1;
+}
+
+void QFoodCalendar::replyReadyRead() {
+    int index = feedOf(sender());
+    if (index < 0)
+        return;
+    QNetworkReply *reply = feeds.at(index)->reply;
+    QByteArray data = reply->readAll();
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+        return;
+    QMetaObject::invokeMethod(parseWorker, "addData", Qt::QueuedConnection,
+                              Q_ARG(int, generation), Q_ARG(int, index), Q_ARG(QByteArray, data));
+}
+
+void QFoodCalendar::replyFinished() {
+    int index = feedOf(sender());
+    if (index < 0)
+        return;
+    Feed *feed = feeds.at(index);
+    QNetworkReply *finished = feed->reply;
+    finished->deleteLater();
+    feed->reply = 0;
+    --inFlight;
+    startRequests();
+
+    if (finished->error() != QNetworkReply::NoError) {
+        feedFailed(index, finished->errorString());
+        return;
+    }
+
+    if (finished->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        feedDone(index);
+        return;
+    }
+
+    feed->etag = finished->rawHeader("ETag");
+    feed->lastModified = finished->rawHeader("Last-Modified");
+    QMetaObject::invokeMethod(parseWorker, "addData", Qt::QueuedConnection,
+                              Q_ARG(int, generation), Q_ARG(int, index), Q_ARG(QByteArray, finished->readAll()));
+    QMetaObject::invokeMethod(parseWorker, "finish", Qt::QueuedConnection,
+                              Q_ARG(int, generation), Q_ARG(int, index));
+}
+
+void QFoodCalendar::daysParsed(int loadGeneration, int index, const QVector<MenuDay> &parsed) {
+    if (loadGeneration != generation || feeds.at(index)->done)
+        return;
+    Feed *feed = feeds.at(index);
+    QVector<MenuEntry> entries = intern(parsed);
+    if (feed->replacing)
+        feed->pending += entries;
+    else
+        appendDays(index, entries);
+}
+
+void QFoodCalendar::parseFinished(int loadGeneration, int index, bool ok, const QString &error) {
+    if (loadGeneration != generation || feeds.at(index)->done)
+        return;
+    Feed *feed = feeds.at(index);
+    if (!ok) {
+        if (feed->reply) {
+            feed->reply->disconnect(this);
+            feed->reply->abort();
+            feed->reply->deleteLater();
+            feed->reply = 0;
+            --inFlight;
+            startRequests();
+        }
+        feedFailed(index, error);
+        return;
+    }
+
+    if (feed->replacing)
+        mergeDays(index);
+    // tyhjä <week/> ei korvaa välimuistin viimeistä oikeaa listaa
+    if (!feed->days.isEmpty())
+        MenuCache(feed->url).store(feed->days, pool, feed->etag, feed->lastModified);
+    archivePending = true;
+    feedDone(index);
+}
+
+// ilman verkkoa näytetään edelleen välimuistin lista
+void QFoodCalendar::feedFailed(int index, const QString &error) {
+    Feed *feed = feeds.at(index);
+    feed->pending.clear();
+    ++failures;
+    lastError = error;
+    qDebug() << "food calendar:" << feed->url.toString() << error
+             << (feed->replacing ? "- keeping previous menu" : "");
+    feedDone(index);
+}
+
+void QFoodCalendar::feedDone(int index) {
+    Feed *feed = feeds.at(index);
+    feed->done = true;
+
+    foreach (const Feed *f, feeds) {
+        if (!f->done)
+            return;
+    }
+
+    if (archivePending) {
+        archivePending = false;
+        archiveDays();
+    }
+
+    if (failures == feeds.count() && rows.isEmpty())
+        setStatus(Error, lastError);
+    else
+        setStatus(Ready);
+}
+
+void QFoodCalendar::setStatus(Status value, const QString &error) {
+    if (value == status && error == errorString)
+        return;
+    status = value;
+    errorString = error;
+    if (status == Error)
+        qDebug() << "food calendar:" << sources << errorString;
+    emit statusChanged();
+}
+
+QVector<MenuEntry> QFoodCalendar::intern(const QVector<MenuDay> &parsed) {
+    QVector<MenuEntry> entries(parsed.count());
+    for (int i = 0; i < parsed.count(); ++i) {
+        const MenuDay &menu = parsed.at(i);
+        MenuEntry &entry = entries[i];
+        entry.date = menu.date;
+        entry.name = pool.intern(menu.name);
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            entry.meals[slot] = pool.intern(menu.meals[slot]);
+    }
+    return entries;
+}
+
+// Arkistoon menee sama yhdistetty näkymä kuin ateriahakuun: ensimmäinen
+// syöte voittaa. Jos syötteet tallentaisivat omansa, ne korvaisivat
+// toistensa päiviä joka päivityksellä ja arkisto kasvaisi turhaan.
+void QFoodCalendar::archiveDays() {
+    QVector<DayRef> refs = primaryDays();
+    QVector<MenuDay> menus(refs.count());
+    for (int i = 0; i < refs.count(); ++i) {
+        MenuDay &menu = menus[i];
+        menu.date = dayDate(refs.at(i));
+        menu.name = dayName(refs.at(i));
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            menu.meals[slot] = mealText(refs.at(i), slot);
+    }
+    int written = archive.append(menus);
+    if (written > 0) {
+        qDebug() << "food calendar: archived" << written << "days";
+        emit archiveChanged();
+    }
+}
+
+bool QFoodCalendar::sameFeeds() const {
+    if (feeds.count() != sources.count())
+        return false;
+    for (int i = 0; i < feeds.count(); ++i) {
+        if (feeds.at(i)->url != QUrl(sources.at(i)))
+            return false;
+    }
+    return !feeds.isEmpty();
+}
+
+// Replaces the days of a feed with the freshly parsed ones. Days are
+// matched by date; rows whose day disappeared are removed, matched rows
+// keep their place and get dataChanged for the roles that differ, and new
+// days are inserted where their date belongs.
+void QFoodCalendar::mergeDays(int index) {
+    Feed *feed = feeds.at(index);
+    QVector<MenuEntry> fresh = feed->pending;
+    feed->pending.clear();
+
+    QHash<qint64, int> freshByDate;
+    for (int i = 0; i < fresh.count(); ++i)
+        freshByDate.insert(fresh.at(i).date.toJulianDay(), i);
+
+    int oldCount = dayCount(index);
+    QVector<int> oldToNew(oldCount, -1);
+    QVector<bool> matched(fresh.count(), false);
+    QVector<bool> changed(fresh.count(), false);
+    QVector<QVector<int> > changedRoles(oldCount);
+    for (int i = 0; i < oldCount; ++i) {
+        DayRef ref = { index, i };
+        QHash<qint64, int>::const_iterator it = freshByDate.constFind(dayDate(ref).toJulianDay());
+        if (it == freshByDate.constEnd() || matched.at(it.value()))
+            continue;
+        int n = it.value();
+        matched[n] = true;
+        oldToNew[i] = n;
+
+        const MenuEntry &entry = fresh.at(n);
+        QVector<int> &roles = changedRoles[i];
+        if (dayName(ref) != pool.text(entry.name))
+            roles << NameRole;
+        for (int slot = 0; slot < MealSlotCount; ++slot) {
+            if (mealText(ref, slot) != pool.text(entry.meals[slot]))
+                roles << BreakfastRole + slot;
+        }
+        // katsomaton muutos säilyy päivityksen yli
+        changed[n] = !roles.isEmpty() || isChanged(ref);
+        if (!roles.isEmpty() && !isChanged(ref))
+            roles << ChangedRole;
+    }
+
+    QString dayNumber = QString::number(day);
+    int removed = 0;
+    for (int row = rows.count() - 1; row >= 0; --row) {
+        const DayRef &ref = rows.at(row);
+        if (ref.feed != index)
+            continue;
+        int n = oldToNew.at(ref.index);
+        if (n >= 0 && (day == 0 || pool.text(fresh.at(n).name) == dayNumber))
+            continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        rows.remove(row);
+        endRemoveRows();
+        ++removed;
+    }
+
+    feed->snapshot.reset();
+    feed->days = fresh;
+    feed->changed = changed;
+
+    QVector<bool> shown(fresh.count(), false);
+    for (int row = 0; row < rows.count(); ++row) {
+        DayRef &ref = rows[row];
+        if (ref.feed != index)
+            continue;
+        int old = ref.index;
+        ref.index = oldToNew.at(old);
+        shown[ref.index] = true;
+        if (!changedRoles.at(old).isEmpty())
+            emit dataChanged(this->index(row), this->index(row), changedRoles.at(old));
+    }
+
+    int inserted = 0;
+    for (int n = 0; n < fresh.count(); ++n) {
+        DayRef ref = { index, n };
+        if (shown.at(n) || !matchesDay(ref))
+            continue;
+        if (!matched.at(n))
+            feed->changed[n] = true;
+        int row = insertPosition(ref);
+        beginInsertRows(QModelIndex(), row, row);
+        rows.insert(row, ref);
+        endInsertRows();
+        ++inserted;
+    }
+
+    if (removed != inserted)
+        emit countChanged();
+    rebuildDayIndex();
+    indexDays();
+}
+
+void QFoodCalendar::appendDays(int index, const QVector<MenuEntry> &parsed) {
+    if (parsed.isEmpty())
+        return;
+
+    Feed *feed = feeds.at(index);
+    int first = feed->days.count();
+    feed->days += parsed;
+    feed->changed.resize(feed->days.count());
+
+    QVector<DayRef> matching;
+    for (int i = first; i < feed->days.count(); ++i) {
+        DayRef ref = { index, i };
+        addToDayIndex(ref);
+        if (matchesDay(ref))
+            matching.append(ref);
+    }
+    if (!matching.isEmpty()) {
+        int previousCount = rows.count();
+        if (insertPosition(matching.first()) == rows.count()) {
+            // tavallisin tapaus: päivät tulevat järjestyksessä listan perään,
+            // yksi insert koko palalle
+            beginInsertRows(QModelIndex(), rows.count(), rows.count() + matching.count() - 1);
+            rows += matching;
+            endInsertRows();
+        } else {
+            foreach (const DayRef &ref, matching) {
+                int row = insertPosition(ref);
+                beginInsertRows(QModelIndex(), row, row);
+                rows.insert(row, ref);
+                endInsertRows();
+            }
+        }
+        if (rows.count() != previousCount)
+            emit countChanged();
+    }
+    indexDays();
+}
+
+// päivän vaihto ei parsi eikä käy läpi listaa, valmis rivilista vain vaihtuu
+void QFoodCalendar::updateRows() {
+    int previousCount = rows.count();
+    beginResetModel();
+    rows = day == 0 ? allRows : rowsByDay.value(QString::number(day));
+    endResetModel();
+    if (rows.count() != previousCount)
+        emit countChanged();
+}
+
+void QFoodCalendar::rebuildRows() {
+    rebuildDayIndex();
+    rows = day == 0 ? allRows : rowsByDay.value(QString::number(day));
+}
+
+// kaikki rivit päiväjärjestyksessä ja valmiiksi jaettuna <day name>:n mukaan
+void QFoodCalendar::rebuildDayIndex() {
+    allRows.clear();
+    rowsByDay.clear();
+    for (int feed = 0; feed < feeds.count(); ++feed) {
+        for (int i = 0; i < dayCount(feed); ++i) {
+            DayRef ref = { feed, i };
+            allRows.append(ref);
+        }
+    }
+    // saman päivän rivit pysyvät syötteiden järjestyksessä
+    DateLess less = { this };
+    std::stable_sort(allRows.begin(), allRows.end(), less);
+    foreach (const DayRef &ref, allRows)
+        rowsByDay[dayName(ref)].append(ref);
+}
+
+// palan päivät lisätään paikoilleen, koko hakemistoa ei rakenneta uudelleen
+void QFoodCalendar::addToDayIndex(const DayRef &ref) {
+    DateLess less = { this };
+    allRows.insert(std::upper_bound(allRows.begin(), allRows.end(), ref, less), ref);
+    QVector<DayRef> &dayRows = rowsByDay[dayName(ref)];
+    dayRows.insert(std::upper_bound(dayRows.begin(), dayRows.end(), ref, less), ref);
+}
+
+// ensimmäinen rivi jonka päivä on refin jälkeen
+int QFoodCalendar::insertPosition(const DayRef &ref) const {
+    DateLess less = { this };
+    return std::upper_bound(rows.begin(), rows.end(), ref, less) - rows.begin();
+}
+
+bool QFoodCalendar::matchesDay(const DayRef &ref) const {
+    return day == 0 || dayName(ref) == QString::number(day);
+}
+
+// yksi päivä per päivämäärä, aiempi syöte voittaa
+QVector<QFoodCalendar::DayRef> QFoodCalendar::primaryDays() const {
+    QVector<DayRef> result;
+    QSet<qint64> seen;
+    for (int feed = 0; feed < feeds.count(); ++feed) {
+        for (int i = 0; i < dayCount(feed); ++i) {
+            DayRef ref = { feed, i };
+            qint64 julianDay = dayDate(ref).toJulianDay();
+            if (seen.contains(julianDay))
+                continue;
+            seen.insert(julianDay);
+            result.append(ref);
+        }
+    }
+    return result;
+}
+
+// kaikki syötteet hakemistoihin, samana päivänä ensimmäinen syöte voittaa
+void QFoodCalendar::indexDays() {
+    mealIndex.clear();
+    bool dishesChanged = false;
+    QString meals[MealSlotCount];
+    foreach (const DayRef &ref, primaryDays()) {
+        QDate date = dayDate(ref);
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            meals[slot] = mealText(ref, slot);
+        mealIndex.insert(date, meals);
+        // historia vain kasvaa, muuttumattomat päivät eivät maksa mitään
+        if (dishIndex.addDay(date, meals))
+            dishesChanged = true;
+    }
+    updateMeals();
+    emit mealIndexChanged();
+    if (dishesChanged)
+        emit dishIndexChanged();
+}
+
+void QFoodCalendar::archiveIndexed(const DishIndex &index) {
+    DishIndex seeded = index;
+    // sillä välin ladatut päivät ovat arkistoa uudempia
+    QString meals[MealSlotCount];
+    foreach (const DayRef &ref, primaryDays()) {
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            meals[slot] = mealText(ref, slot);
+        seeded.addDay(dayDate(ref), meals);
+    }
+    dishIndex = seeded;
+    emit dishIndexChanged();
+}
+
+void QFoodCalendar::setActive(bool value) {
+    if (value == active)
+        return;
+    active = value;
+    if (active)
+        updateMeals();
+    else
+        WakeupScheduler::instance()->cancel(this, "updateMeals");
+}
+
+void QFoodCalendar::updateMeals() {
+    // piilossa ateriat päivitetään vasta näkyviin tultaessa
+    if (!active)
+        return;
+    QDateTime now = QDateTime::currentDateTime();
+    MealIndex::Meal current = mealIndex.current(now);
+    MealIndex::Meal next = mealIndex.next(now);
+
+    // herätys vasta kun seuraava ateria alkaa
+    WakeupScheduler::instance()->schedule(this, "updateMeals", next.start);
+
+    if (current.slot == currentMeal.slot && current.text == currentMeal.text
+            && next.start == nextMeal.start && next.text == nextMeal.text)
+        return;
+    currentMeal = current;
+    nextMeal = next;
+    emit mealsChanged();
+}
+
+// rivit tulevat joko mapatusta välimuistista tai juuri parsituista päivistä
+int QFoodCalendar::dayCount(int feed) const {
+    const Feed *f = feeds.at(feed);
+    return f->snapshot ? f->snapshot->dayCount() : f->days.count();
+}
+
+QString QFoodCalendar::dayName(const DayRef &ref) const {
+    const Feed *feed = feeds.at(ref.feed);
+    return feed->snapshot ? feed->snapshot->name(ref.index) : pool.text(feed->days.at(ref.index).name);
+}
+
+QDate QFoodCalendar::dayDate(const DayRef &ref) const {
+    const Feed *feed = feeds.at(ref.feed);
+    return feed->snapshot ? feed->snapshot->date(ref.index) : feed->days.at(ref.index).date;
+}
+
+QString QFoodCalendar::mealText(const DayRef &ref, int slot) const {
+    const Feed *feed = feeds.at(ref.feed);
+    return feed->snapshot ? feed->snapshot->meal(ref.index, slot) : pool.text(feed->days.at(ref.index).meals[slot]);
+}
+
+bool QFoodCalendar::isChanged(const DayRef &ref) const {
+    const Feed *feed = feeds.at(ref.feed);
+    return !feed->snapshot && feed->changed.at(ref.index);
 }
@@ -1,18 +1,267 @@
 #ifndef QFOODCALENDAR_H
 #define QFOODCALENDAR_H
 
-#include <QObject>
+#include <QAbstractListModel>
+#include <QUrl>
+#include <QList>
+#include <QVector>
+#include <QStringList>
+#include <QScopedPointer>
+#include <QThread>
+#include "menuday.h"
+#include "menuparser.h"
+#include "menusnapshot.h"
+#include "dishpool.h"
+#include "mealindex.h"
+#include "dishindex.h"
+#include "menuarchive.h"
 
-class QFoodCalendar : public QObject
+class MealConfig;
+class MenuParseWorker;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// food.xml feeds as one list model, one row per <day>, ordered by date.
+// Replaces the QML XmlListModel: every feed is downloaded with at most
+// MaxRequests requests in flight, its bytes are parsed with
+// QXmlStreamReader in a parser thread while they arrive, and every <day>
+// becomes a row as soon as it has been closed. The roles are served from
+// plain structs whose texts are interned in a DishPool that outlives
+// reloads; the source role tells which feed a row came from.
+//
+// The last good menu of each feed is cached on disk as a mapped
+// MenuSnapshot and served straight from the mapping at startup; the feed
+// is then revalidated with If-None-Match / If-Modified-Since and only a
+// 200 replaces what is on screen. A refreshed feed is compared with what
+// is shown day by day and meal by meal, so only changed rows are
+// signalled and views keep their delegates and scroll position. Rows that
+// changed stay flagged until markSeen().
+//
+// The rows of every <day name> are kept ready whenever the content
+// changes, so selecting a day only swaps the row list. Streamed days are
+// filed into those lists in place; only a refresh merge rebuilds them.
+//
+// Every loaded day is also kept in a MealIndex so the current and next meal
+// are answered by date lookup; the WakeupScheduler wakes the model up at
+// the next meal change instead of polling; while the app is hidden
+// (setActive(false)) there is no wakeup at all. After each load the merged
+// menu (the first feed wins for a date, as in the MealIndex) is appended to
+// a MenuArchive, which seeds the DishIndex used for searching the menu
+// history.
+class QFoodCalendar : public QAbstractListModel
 {
     Q_OBJECT
+    Q_ENUMS(Status)
+
+    Q_PROPERTY(QUrl source READ getSource WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QStringList sources READ getSources WRITE setSources NOTIFY sourcesChanged)
+    Q_PROPERTY(int day READ getDay WRITE setDay NOTIFY dayChanged)
+    Q_PROPERTY(Status status READ getStatus NOTIFY statusChanged)
+    Q_PROPERTY(QString errorString READ getErrorString NOTIFY statusChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(QString currentMeal READ getCurrentMeal NOTIFY mealsChanged)
+    Q_PROPERTY(QString currentMealText READ getCurrentMealText NOTIFY mealsChanged)
+    Q_PROPERTY(QString nextMeal READ getNextMeal NOTIFY mealsChanged)
+    Q_PROPERTY(QString nextMealText READ getNextMealText NOTIFY mealsChanged)
+    Q_PROPERTY(QDateTime nextTransition READ getNextTransition NOTIFY mealsChanged)
+
 public:
+    enum Status {
+        Null,
+        Loading,
+        Ready,
+        Error
+    };
+
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        DateRole,
+        BreakfastRole,
+        LunchRole,
+        DinnerRole,
+        SupperRole,
+        SourceRole,
+        ChangedRole
+    };
+
     explicit QFoodCalendar(QObject *parent = 0);
+    ~QFoodCalendar();
 
-signals:
+    // ensimmäinen syöte, yhden syötteen käyttäjille
+    QUrl getSource() const;
+    void setSource(const QUrl &url);
+
+    inline const QStringList &getSources() const {
+        return sources;
+    }
+    void setSources(const QStringList &urls);
+
+    // 0 näyttää koko viikon, muuten vain <day name="n">
+    inline int getDay() const {
+        return day;
+    }
+    void setDay(int day);
+
+    inline Status getStatus() const {
+        return status;
+    }
+
+    inline const QString &getErrorString() const {
+        return errorString;
+    }
+
+    inline const MealIndex &getMealIndex() const {
+        return mealIndex;
+    }
+    inline const DishIndex &getDishIndex() const {
+        return dishIndex;
+    }
+
+    // Historia on oma mallinsa (MenuHistory, calendar: Menu): tämän mallin
+    // rivit ovat syötteiden päiviä päiväsuodattimella, historian rivit
+    // arkiston kaikki päivät ilman suodatinta.
+    inline const MenuArchive &getArchive() const {
+        return archive;
+    }
+
+    // ruoka-ajat luetaan configista aina kun ne muuttuvat
+    void setMealConfig(MealConfig *config);
+
+    // tyhjä ennen päivän ensimmäistä ateriaa
+    inline QString getCurrentMeal() const {
+        return MealSchedule::slotTitle(currentMeal.slot);
+    }
+    inline const QString &getCurrentMealText() const {
+        return currentMeal.text;
+    }
+    inline QString getNextMeal() const {
+        return MealSchedule::slotTitle(nextMeal.slot);
+    }
+    inline const QString &getNextMealText() const {
+        return nextMeal.text;
+    }
+    inline const QDateTime &getNextTransition() const {
+        return nextMeal.start;
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QHash<int, QByteArray> roleNames() const;
 
 public slots:
+    void reload();
+    // nollaa muuttuneiden rivien korostuksen
+    void markSeen();
+    void setActive(bool active);
+
+signals:
+    void sourceChanged();
+    void sourcesChanged();
+    void dayChanged();
+    void statusChanged();
+    void countChanged();
+    void mealsChanged();
+    // päiviä tai ruoka-aikoja muutettu, tulevat ateriat voivat olla toisin
+    void mealIndexChanged();
+    void dishIndexChanged();
+    void archiveChanged();
+
+private slots:
+    void replyReadyRead();
+    void replyFinished();
+    void daysParsed(int generation, int feed, const QVector<MenuDay> &days);
+    void parseFinished(int generation, int feed, bool ok, const QString &error);
+    void updateMeals();
+    void mealScheduleChanged();
+    void archiveIndexed(const DishIndex &index);
+
+private:
+    static const int MaxRequests = 3;
+
+    struct Feed {
+        Feed() : reply(0), replacing(false), done(false) {}
+        QUrl url;
+        QNetworkReply *reply;
+        QScopedPointer<MenuSnapshot> snapshot;
+        QVector<MenuEntry> days;
+        QVector<MenuEntry> pending;
+        // days-taulukon rinnalla, muuttunut edellisen katselun jälkeen
+        QVector<bool> changed;
+        QByteArray etag;
+        QByteArray lastModified;
+        bool replacing;
+        bool done;
+    };
+
+    // rivi osoittaa syötteen päivään
+    struct DayRef {
+        int feed;
+        int index;
+    };
+
+    struct DateLess {
+        const QFoodCalendar *calendar;
+        // saman päivän rivit syötteiden järjestyksessä
+        inline bool operator()(const DayRef &a, const DayRef &b) const {
+            QDate dateA = calendar->dayDate(a);
+            QDate dateB = calendar->dayDate(b);
+            return dateA < dateB || (dateA == dateB && a.feed < b.feed);
+        }
+    };
+
+    void startRequests();
+    void abortRequests();
+    int feedOf(QObject *reply) const;
+    void feedFailed(int feed, const QString &error);
+    void feedDone(int feed);
+    void setStatus(Status status, const QString &error = QString());
+    QVector<MenuEntry> intern(const QVector<MenuDay> &parsed);
+    void archiveDays();
+    bool sameFeeds() const;
+    void mergeDays(int feed);
+    void appendDays(int feed, const QVector<MenuEntry> &days);
+    void updateRows();
+    void rebuildRows();
+    void rebuildDayIndex();
+    void addToDayIndex(const DayRef &ref);
+    int insertPosition(const DayRef &ref) const;
+    bool matchesDay(const DayRef &ref) const;
+    void indexDays();
+    QVector<DayRef> primaryDays() const;
+
+    int dayCount(int feed) const;
+    QString dayName(const DayRef &ref) const;
+    QDate dayDate(const DayRef &ref) const;
+    QString mealText(const DayRef &ref, int slot) const;
+    bool isChanged(const DayRef &ref) const;
+
+    QNetworkAccessManager *network;
+    QThread parserThread;
+    MenuParseWorker *parseWorker;
+    QList<Feed *> feeds;
+    QList<int> queue;
+    int inFlight;
+    int generation;
+    int failures;
+    bool archivePending;
+    QString lastError;
+    QStringList sources;
+    int day;
+    Status status;
+    QString errorString;
+
+    DishPool pool;
+    QVector<DayRef> rows;
+    QVector<DayRef> allRows;
+    QHash<QString, QVector<DayRef> > rowsByDay;
 
+    MealConfig *mealConfig;
+    bool active;
+    MealIndex mealIndex;
+    DishIndex dishIndex;
+    MenuArchive archive;
+    MealIndex::Meal currentMeal;
+    MealIndex::Meal nextMeal;
 };
 
 #endif // QFOODCALENDAR_H
@@ -0,0 +1,236 @@
+#include "qmenuhistory.h"
+#include "menupageloader.h"
+#include "menuparser.h"
+
+QMenuHistory::QMenuHistory(QObject *parent) :
+    QAbstractListModel(parent), loader(new MenuPageLoader), firstDay(0), days(0),
+    memoryBudget(256 * 1024), usedBytes(0), blocksSeen(0), useCounter(0)
+{
+    qRegisterMetaType<QVector<MenuDay> >("QVector<MenuDay>");
+    loader->moveToThread(&loaderThread);
+    connect(loader, SIGNAL(loaded(qint64,QVector<MenuDay>)), this, SLOT(pageLoaded(qint64,QVector<MenuDay>)));
+    loaderThread.setObjectName("menupages");
+    loaderThread.start(QThread::LowPriority);
+}
+
+QMenuHistory::~QMenuHistory() {
+    loaderThread.quit();
+    loaderThread.wait();
+    delete loader;
+}
+
+void QMenuHistory::setCalendar(QFoodCalendar *value) {
+    if (value == calendar)
+        return;
+    if (calendar)
+        calendar->disconnect(this);
+    calendar = value;
+    if (calendar)
+        connect(calendar, SIGNAL(archiveChanged()), this, SLOT(archiveChanged()));
+    emit calendarChanged();
+
+    // uusi kalenteri, kaikki alusta
+    reset(0, 0);
+    archiveChanged();
+}
+
+void QMenuHistory::setMemoryBudget(int bytes) {
+    if (bytes == memoryBudget)
+        return;
+    memoryBudget = qMax(0, bytes);
+    evict();
+    emit memoryBudgetChanged();
+}
+
+int QMenuHistory::rowOf(const QDate &date) const {
+    if (!date.isValid() || days == 0)
+        return -1;
+    qint64 row = date.toJulianDay() - firstDay;
+    return row >= 0 && row < days ? int(row) : -1;
+}
+
+int QMenuHistory::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : days;
+}
+
+QVariant QMenuHistory::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= days)
+        return QVariant();
+
+    qint64 julianDay = firstDay + index.row();
+    if (role == DateRole)
+        return QDate::fromJulianDay(julianDay);
+
+    qint64 weekStart = weekOf(julianDay);
+    QHash<qint64, Page>::iterator page = pages.find(weekStart);
+    if (page == pages.end()) {
+        // ei koskaan odoteta levyä, rivi täyttyy kun viikko on luettu
+        request(weekStart);
+        request(weekStart - 7);
+        request(weekStart + 7);
+        return role == LoadedRole ? QVariant(false) : QVariant();
+    }
+    page.value().lastUsed = ++useCounter;
+
+    if (role == LoadedRole)
+        return true;
+    QHash<qint64, MenuDay>::const_iterator day = page.value().days.constFind(julianDay);
+    if (day == page.value().days.constEnd())
+        return QVariant();
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return day.value().name;
+    case BreakfastRole:
+    case LunchRole:
+    case DinnerRole:
+    case SupperRole:
+        return day.value().meals[role - BreakfastRole];
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> QMenuHistory::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[DateRole] = "date";
+    roles[NameRole] = "name";
+    roles[BreakfastRole] = MenuParser::slotElement(Breakfast);
+    roles[LunchRole] = MenuParser::slotElement(Lunch);
+    roles[DinnerRole] = MenuParser::slotElement(Dinner);
+    roles[SupperRole] = MenuParser::slotElement(Supper);
+    roles[LoadedRole] = "loaded";
+    return roles;
+}
+
+// Arkistoon tuli uusia lohkoja. Väli voi vain kasvaa, joten rivit lisätään
+// reunoille ja vain uusien lohkojen viikot luetaan uudelleen.
+void QMenuHistory::archiveChanged() {
+    if (!calendar) {
+        reset(0, 0);
+        return;
+    }
+    const MenuArchive &archive = calendar->getArchive();
+    // jonossa ennen seuraavia lukuja, joten ne näkevät uudet lohkot
+    QMetaObject::invokeMethod(loader, "reopen", Qt::QueuedConnection, Q_ARG(QString, archive.getFileName()));
+
+    QDate first = archive.firstDate();
+    QDate last = archive.lastDate();
+    if (!first.isValid() || !last.isValid()) {
+        reset(0, 0);
+        return;
+    }
+    qint64 newFirst = first.toJulianDay();
+    qint64 newLast = last.toJulianDay();
+    qint64 oldLast = firstDay + days - 1;
+    if (days == 0 || archive.blockCount() < blocksSeen || newFirst > firstDay || newLast < oldLast) {
+        reset(newFirst, int(newLast - newFirst + 1));
+        blocksSeen = archive.blockCount();
+        return;
+    }
+
+    int previousCount = days;
+    if (newFirst < firstDay) {
+        int added = int(firstDay - newFirst);
+        beginInsertRows(QModelIndex(), 0, added - 1);
+        firstDay = newFirst;
+        days += added;
+        endInsertRows();
+    }
+    if (newLast > oldLast) {
+        int added = int(newLast - oldLast);
+        beginInsertRows(QModelIndex(), days, days + added - 1);
+        days += added;
+        endInsertRows();
+    }
+    if (days != previousCount)
+        emit countChanged();
+
+    for (int block = blocksSeen; block < archive.blockCount(); ++block) {
+        qint64 blockLast = archive.blockLastDate(block).toJulianDay();
+        for (qint64 week = weekOf(archive.blockFirstDate(block).toJulianDay()); week <= blockLast; week += 7)
+            reload(week);
+    }
+    blocksSeen = archive.blockCount();
+}
+
+void QMenuHistory::reset(qint64 first, int count) {
+    int previousCount = days;
+    beginResetModel();
+    pages.clear();
+    requested.clear();
+    stale.clear();
+    usedBytes = 0;
+    blocksSeen = 0;
+    firstDay = first;
+    days = count;
+    endResetModel();
+    if (days != previousCount)
+        emit countChanged();
+}
+
+// ladattu viikko luetaan uudelleen, vanhat rivit näkyvät siihen asti
+void QMenuHistory::reload(qint64 weekStart) {
+    if (requested.contains(weekStart)) {
+        stale.insert(weekStart);
+    } else if (pages.contains(weekStart)) {
+        requested.insert(weekStart);
+        QMetaObject::invokeMethod(loader, "load", Qt::QueuedConnection, Q_ARG(qint64, weekStart));
+    }
+}
+
+void QMenuHistory::pageLoaded(qint64 weekStart, const QVector<MenuDay> &loaded) {
+    // sivu on voinut vanhentua arkiston päivityksessä
+    if (!requested.contains(weekStart))
+        return;
+    if (stale.remove(weekStart)) {
+        QMetaObject::invokeMethod(loader, "load", Qt::QueuedConnection, Q_ARG(qint64, weekStart));
+        return;
+    }
+    requested.remove(weekStart);
+
+    Page &page = pages[weekStart];
+    usedBytes -= page.bytes;
+    page.days.clear();
+    page.bytes = 0;
+    page.lastUsed = ++useCounter;
+    foreach (const MenuDay &menu, loaded) {
+        page.days.insert(menu.date.toJulianDay(), menu);
+        page.bytes += int(sizeof(MenuDay)) + menu.name.size() * 2;
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            page.bytes += menu.meals[slot].size() * 2;
+    }
+    usedBytes += page.bytes;
+    weekChanged(weekStart);
+    evict();
+}
+
+void QMenuHistory::request(qint64 weekStart) const {
+    qint64 lastDay = firstDay + days - 1;
+    if (weekStart + 6 < firstDay || weekStart > lastDay)
+        return;
+    if (pages.contains(weekStart) || requested.contains(weekStart))
+        return;
+    requested.insert(weekStart);
+    QMetaObject::invokeMethod(loader, "load", Qt::QueuedConnection, Q_ARG(qint64, weekStart));
+}
+
+// vähiten aikaa sitten näytetyt viikot pois kunnes budjetti riittää
+void QMenuHistory::evict() {
+    while (usedBytes > memoryBudget && pages.count() > 3) {
+        QHash<qint64, Page>::iterator oldest = pages.begin();
+        for (QHash<qint64, Page>::iterator it = pages.begin(); it != pages.end(); ++it) {
+            if (it.value().lastUsed < oldest.value().lastUsed)
+                oldest = it;
+        }
+        usedBytes -= oldest.value().bytes;
+        // näkyvät delegaatit pitävät arvonsa, uudet pyytävät viikon uudelleen
+        pages.erase(oldest);
+    }
+}
+
+void QMenuHistory::weekChanged(qint64 weekStart) {
+    int first = qMax<qint64>(weekStart - firstDay, 0);
+    int last = qMin<qint64>(weekStart + 6 - firstDay, days - 1);
+    if (first <= last)
+        emit dataChanged(index(first), index(last));
+}
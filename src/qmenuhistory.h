@@ -0,0 +1,106 @@
+#ifndef QMENUHISTORY_H
+#define QMENUHISTORY_H
+
+#include <QAbstractListModel>
+#include <QDate>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QPointer>
+#include "menuday.h"
+#include "qfoodcalendar.h"
+
+class MenuPageLoader;
+
+// Every archived day as one row, oldest first, for swiping through the
+// whole menu history. Rows exist for the full date range up front, but
+// only weeks that views have asked for are materialized: a missing week
+// is read from the archive in a loader thread together with its
+// neighbours, and its rows report loaded = false until it arrives. Weeks
+// least recently shown are dropped once the pages exceed memoryBudget.
+//
+// When the archive grows, rows are inserted at whichever end the date
+// range grew and only the loaded weeks that the new blocks touch are read
+// again; views keep their position and every other week.
+class QMenuHistory : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QFoodCalendar *calendar READ getCalendar WRITE setCalendar NOTIFY calendarChanged)
+    Q_PROPERTY(int memoryBudget READ getMemoryBudget WRITE setMemoryBudget NOTIFY memoryBudgetChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        DateRole = Qt::UserRole + 1,
+        NameRole,
+        BreakfastRole,
+        LunchRole,
+        DinnerRole,
+        SupperRole,
+        LoadedRole
+    };
+
+    explicit QMenuHistory(QObject *parent = 0);
+    ~QMenuHistory();
+
+    inline QFoodCalendar *getCalendar() const {
+        return calendar;
+    }
+    void setCalendar(QFoodCalendar *calendar);
+
+    inline int getMemoryBudget() const {
+        return memoryBudget;
+    }
+    void setMemoryBudget(int bytes);
+
+    Q_INVOKABLE int rowOf(const QDate &date) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QHash<int, QByteArray> roleNames() const;
+
+signals:
+    void calendarChanged();
+    void memoryBudgetChanged();
+    void countChanged();
+
+private slots:
+    void archiveChanged();
+    void pageLoaded(qint64 weekStart, const QVector<MenuDay> &days);
+
+private:
+    struct Page {
+        Page() : bytes(0), lastUsed(0) {}
+        QHash<qint64, MenuDay> days;
+        int bytes;
+        quint64 lastUsed;
+    };
+
+    static inline qint64 weekOf(qint64 julianDay) {
+        return julianDay - QDate::fromJulianDay(julianDay).dayOfWeek() + 1;
+    }
+    void request(qint64 weekStart) const;
+    void reload(qint64 weekStart);
+    void reset(qint64 first, int count);
+    void evict();
+    void weekChanged(qint64 weekStart);
+
+    QPointer<QFoodCalendar> calendar;
+    QThread loaderThread;
+    MenuPageLoader *loader;
+    qint64 firstDay;
+    int days;
+    int memoryBudget;
+    int usedBytes;
+    int blocksSeen;
+
+    // data() on const, mutta välimuisti ja LRU päivittyvät lukiessa
+    mutable QHash<qint64, Page> pages;
+    mutable QSet<qint64> requested;
+    // luku oli jo matkalla kun viikko muuttui, luetaan vielä kerran
+    QSet<qint64> stale;
+    mutable quint64 useCounter;
+};
+
+#endif // QMENUHISTORY_H
@@ -0,0 +1,87 @@
+#include "qmenusearch.h"
+#include "qfoodcalendar.h"
+
+QMenuSearch::QMenuSearch(QObject *parent) :
+    QAbstractListModel(parent)
+{
+}
+
+void QMenuSearch::setCalendar(QFoodCalendar *value) {
+    if (value == calendar)
+        return;
+    if (calendar)
+        calendar->disconnect(this);
+    calendar = value;
+    if (calendar)
+        connect(calendar, SIGNAL(dishIndexChanged()), this, SLOT(refresh()));
+    emit calendarChanged();
+    refresh();
+}
+
+void QMenuSearch::setQuery(const QString &value) {
+    if (value == query)
+        return;
+    query = value;
+    emit queryChanged();
+    refresh();
+}
+
+void QMenuSearch::setFrom(const QDate &date) {
+    if (date == from)
+        return;
+    from = date;
+    emit rangeChanged();
+    refresh();
+}
+
+void QMenuSearch::setTo(const QDate &date) {
+    if (date == to)
+        return;
+    to = date;
+    emit rangeChanged();
+    refresh();
+}
+
+int QMenuSearch::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : results.count();
+}
+
+QVariant QMenuSearch::data(const QModelIndex &index, int role) const {
+    if (!calendar || !index.isValid() || index.row() >= results.count())
+        return QVariant();
+
+    const DishIndex::Posting &posting = results.at(index.row());
+    switch (role) {
+    case DateRole:
+        return QDate::fromJulianDay(posting.julianDay);
+    case MealRole:
+        return MealSchedule::slotTitle(posting.slot);
+    case SlotRole:
+        return posting.slot;
+    case Qt::DisplayRole:
+    case TextRole:
+        return calendar->getDishIndex().text(posting);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> QMenuSearch::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[DateRole] = "date";
+    roles[MealRole] = "meal";
+    roles[SlotRole] = "slot";
+    roles[TextRole] = "text";
+    return roles;
+}
+
+void QMenuSearch::refresh() {
+    int previousCount = results.count();
+    beginResetModel();
+    results.clear();
+    if (calendar && !query.trimmed().isEmpty()) {
+        results = calendar->getDishIndex().search(query, from, to);
+    }
+    endResetModel();
+    if (results.count() != previousCount)
+        emit countChanged();
+}
@@ -0,0 +1,75 @@
+#ifndef QMENUSEARCH_H
+#define QMENUSEARCH_H
+
+#include <QAbstractListModel>
+#include <QDate>
+#include <QPointer>
+#include "dishindex.h"
+#include "qfoodcalendar.h"
+
+// Search results over the menu history of a FoodCalendar, one row per
+// (date, meal) whose dish matches every word of the query as a prefix.
+// Optional from/to limit the dates. Follows the calendar: results are
+// refreshed whenever new days are indexed.
+class QMenuSearch : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QFoodCalendar *calendar READ getCalendar WRITE setCalendar NOTIFY calendarChanged)
+    Q_PROPERTY(QString query READ getQuery WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(QDate from READ getFrom WRITE setFrom NOTIFY rangeChanged)
+    Q_PROPERTY(QDate to READ getTo WRITE setTo NOTIFY rangeChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        DateRole = Qt::UserRole + 1,
+        MealRole,
+        SlotRole,
+        TextRole
+    };
+
+    explicit QMenuSearch(QObject *parent = 0);
+
+    inline QFoodCalendar *getCalendar() const {
+        return calendar;
+    }
+    void setCalendar(QFoodCalendar *calendar);
+
+    inline const QString &getQuery() const {
+        return query;
+    }
+    void setQuery(const QString &query);
+
+    inline const QDate &getFrom() const {
+        return from;
+    }
+    void setFrom(const QDate &date);
+
+    inline const QDate &getTo() const {
+        return to;
+    }
+    void setTo(const QDate &date);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QHash<int, QByteArray> roleNames() const;
+
+signals:
+    void calendarChanged();
+    void queryChanged();
+    void rangeChanged();
+    void countChanged();
+
+private slots:
+    void refresh();
+
+private:
+    QPointer<QFoodCalendar> calendar;
+    QString query;
+    QDate from;
+    QDate to;
+    QVector<DishIndex::Posting> results;
+};
+
+#endif // QMENUSEARCH_H
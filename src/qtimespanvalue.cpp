@@ -0,0 +1,74 @@
+#include "qtimespanvalue.h"
+#include <qmath.h>
+
+QTimeSpanValue::QTimeSpanValue(QObject *parent) :
+    QObject(parent), decomposed(false)
+{
+    for (int i = 0; i < PartCount; ++i)
+        parts[i] = 0;
+}
+
+// Viitehetki (laskentahetki) vaihtuu joka laskennalla, joten sitä ei
+// verrata: muutos on vain jos pituus tai kotiutuspäivä muuttui. text()-
+// välimuisti säilyy, sen rivit tarkistetaan luvusta josta ne tehtiin.
+void QTimeSpanValue::setSpan(const QTimeSpan &value) {
+    if (value.toMSecs() == span.toMSecs() && value.referencedDate() == span.referencedDate())
+        return;
+    span = value;
+    decomposed = false;
+    formatted.clear();
+    emit changed();
+}
+
+QString QTimeSpanValue::format(const QString &pattern) const {
+    QHash<QString, QString>::const_iterator it = formatted.constFind(pattern);
+    if (it != formatted.constEnd())
+        return it.value();
+    QString text = span.abs().toString(pattern);
+    formatted.insert(pattern, text);
+    return text;
+}
+
+QString QTimeSpanValue::text(Unit unit, int decimals) const {
+    // ennen ensimmäistä laskentaa ei ole mitä näyttää
+    if (!isValid())
+        return QString();
+    decimals = qBound(0, decimals, 3);
+    qint64 scale = 1;
+    for (int i = 0; i < decimals; ++i)
+        scale *= 10;
+    qreal value = valueOf(unit);
+    qint64 scaled = qRound64(value * scale);
+
+    // sama pyöristetty luku kuin viimeksi, sama merkkijono
+    Text &cached = texts[unit * 4 + decimals];
+    if (cached.text.isEmpty() || cached.scaled != scaled) {
+        cached.scaled = scaled;
+        plural.format(cached.text, value, PluralFormatter::Unit(unit), decimals);
+    }
+    return cached.text;
+}
+
+qreal QTimeSpanValue::valueOf(Unit unit) const {
+    switch (unit) {
+    case Mornings:
+        // pitää laskea kans viiminen päivä mukaan
+        return qAbs(int(span.toDays()) + 1);
+    case Days:
+        return span.toDays();
+    case Weeks:
+        return span.toWeeks();
+    case Months:
+        return span.toMonths();
+    case Hours:
+        return span.toHours();
+    }
+    return 0;
+}
+
+void QTimeSpanValue::decompose() const {
+    if (decomposed)
+        return;
+    span.abs().parts(0, &parts[SecondsPart], &parts[MinutesPart], &parts[HoursPart], &parts[DaysPart]);
+    decomposed = true;
+}
@@ -0,0 +1,152 @@
+#ifndef QTIMESPANVALUE_H
+#define QTIMESPANVALUE_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include "qtimespan.h"
+#include "pluralformatter.h"
+
+// Read-only view of a QTimeSpan for QML. Bindings get plain numbers and
+// only ask for text that is actually shown. text() gives "12 aamua",
+// "3,5 kuukautta" through PluralFormatter and keeps each string together
+// with the rounded number it was printed from, so a new span only
+// reformats what really changed. The texts the pages show are properties
+// as well (morningsText, daysText, weeksText and monthsText, the last two
+// with one decimal), so bindings on them follow changed(). format()
+// results are dropped when the span changes. The parts are decomposed once
+// per span, on first use.
+class QTimeSpanValue : public QObject
+{
+    Q_OBJECT
+    Q_ENUMS(Unit)
+
+    Q_PROPERTY(bool valid READ isValid NOTIFY changed)
+    Q_PROPERTY(bool negative READ isNegative NOTIFY changed)
+    Q_PROPERTY(QDateTime referenceDate READ getReferenceDate NOTIFY changed)
+    Q_PROPERTY(QDateTime referencedDate READ getReferencedDate NOTIFY changed)
+    Q_PROPERTY(qreal totalSeconds READ getTotalSeconds NOTIFY changed)
+    Q_PROPERTY(qreal totalHours READ getTotalHours NOTIFY changed)
+    Q_PROPERTY(qreal totalDays READ getTotalDays NOTIFY changed)
+    Q_PROPERTY(qreal totalWeeks READ getTotalWeeks NOTIFY changed)
+    Q_PROPERTY(qreal totalMonths READ getTotalMonths NOTIFY changed)
+    Q_PROPERTY(int days READ getDays NOTIFY changed)
+    Q_PROPERTY(int hours READ getHours NOTIFY changed)
+    Q_PROPERTY(int minutes READ getMinutes NOTIFY changed)
+    Q_PROPERTY(int seconds READ getSeconds NOTIFY changed)
+    Q_PROPERTY(QString morningsText READ getMorningsText NOTIFY changed)
+    Q_PROPERTY(QString daysText READ getDaysText NOTIFY changed)
+    Q_PROPERTY(QString weeksText READ getWeeksText NOTIFY changed)
+    Q_PROPERTY(QString monthsText READ getMonthsText NOTIFY changed)
+
+public:
+    // Mornings laskee viimeisenkin päivän mukaan: 0,5 päivää on 1 aamu
+    enum Unit {
+        Mornings = PluralFormatter::Morning,
+        Days = PluralFormatter::Day,
+        Weeks = PluralFormatter::Week,
+        Months = PluralFormatter::Month,
+        Hours = PluralFormatter::Hour
+    };
+
+    explicit QTimeSpanValue(QObject *parent = 0);
+
+    inline const QTimeSpan &getSpan() const {
+        return span;
+    }
+    void setSpan(const QTimeSpan &span);
+
+    inline bool isValid() const {
+        return span.hasValidReference();
+    }
+    inline bool isNegative() const {
+        return span.isNegative();
+    }
+    inline QDateTime getReferenceDate() const {
+        return span.referenceDate();
+    }
+    inline QDateTime getReferencedDate() const {
+        return span.referencedDate();
+    }
+
+    inline qreal getTotalSeconds() const {
+        return span.toSecs();
+    }
+    inline qreal getTotalHours() const {
+        return span.toHours();
+    }
+    inline qreal getTotalDays() const {
+        return span.toDays();
+    }
+    inline qreal getTotalWeeks() const {
+        return span.toWeeks();
+    }
+    inline qreal getTotalMonths() const {
+        return span.toMonths();
+    }
+
+    // päivät + hh:mm:ss, aina itseisarvona
+    inline int getDays() const {
+        decompose();
+        return parts[DaysPart];
+    }
+    inline int getHours() const {
+        decompose();
+        return parts[HoursPart];
+    }
+    inline int getMinutes() const {
+        decompose();
+        return parts[MinutesPart];
+    }
+    inline int getSeconds() const {
+        decompose();
+        return parts[SecondsPart];
+    }
+
+    // QTimeSpan::toString() muoto, esim. "d 'päivää' hh:mm:ss"
+    Q_INVOKABLE QString format(const QString &pattern) const;
+
+    Q_INVOKABLE QString text(Unit unit, int decimals = 0) const;
+
+    inline QString getMorningsText() const {
+        return text(Mornings);
+    }
+    inline QString getDaysText() const {
+        return text(Days);
+    }
+    inline QString getWeeksText() const {
+        return text(Weeks, 1);
+    }
+    inline QString getMonthsText() const {
+        return text(Months, 1);
+    }
+
+signals:
+    void changed();
+
+private:
+    enum Part {
+        SecondsPart,
+        MinutesPart,
+        HoursPart,
+        DaysPart,
+        PartCount
+    };
+
+    struct Text {
+        qint64 scaled;
+        QString text;
+    };
+
+    void decompose() const;
+    qreal valueOf(Unit unit) const;
+
+    QTimeSpan span;
+    PluralFormatter plural;
+    mutable int parts[PartCount];
+    mutable bool decomposed;
+    mutable QHash<QString, QString> formatted;
+    mutable QHash<int, Text> texts;
+};
+
+#endif // QTIMESPANVALUE_H
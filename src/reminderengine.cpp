@@ -0,0 +1,74 @@
+#include "reminderengine.h"
+#include "qfoodcalendar.h"
+#include "mealconfig.h"
+#include "wakeupscheduler.h"
+#include <QDebug>
+
+ReminderEngine::ReminderEngine(QFoodCalendar *calendar, MealConfig *config, ReminderSink *sink, QObject *parent) :
+    QObject(parent), calendar(calendar), config(config), sink(sink), delivered(0)
+{
+    connect(calendar, SIGNAL(mealIndexChanged()), this, SLOT(rebuild()));
+    connect(config, SIGNAL(reminderMinutesChanged()), this, SLOT(rebuild()));
+    rebuild();
+}
+
+void ReminderEngine::rebuild() {
+    queue.clear();
+    int lead = config ? config->getReminderMinutes() : 0;
+    if (!calendar || lead <= 0) {
+        WakeupScheduler::instance()->cancel(this, "deliverDue");
+        return;
+    }
+
+    // seuraavat QueueLength alkamatonta ateriaa. Jos muistutushetki ehti
+    // jo mennä, muistutetaan heti: menun päivitys muistutusikkunan sisällä
+    // ei saa pudottaa seuraavaa ateriaa.
+    const MealIndex &index = calendar->getMealIndex();
+    QDateTime now = WakeupScheduler::instance()->currentDateTime();
+    QDateTime at = now;
+    // jo muistutettua ateriaa ei muistuteta toista kertaa
+    if (lastDelivered.isValid() && lastDelivered > at)
+        at = lastDelivered;
+    while (queue.count() < QueueLength) {
+        MealIndex::Meal meal = index.next(at);
+        Reminder reminder;
+        reminder.mealStart = meal.start;
+        reminder.at = qMax(meal.start.addSecs(-lead * 60), now);
+        reminder.slot = meal.slot;
+        reminder.text = meal.text;
+        queue.append(reminder);
+        at = meal.start;
+    }
+
+    // lähekkäiset yhdistetään myöhempään hetkeen, ei koskaan aiempaan:
+    // ensimmäinen myöhästyy enintään MergeWindow verran ja vain ateriansa
+    // alkuun asti
+    const Reminder &first = queue.first();
+    QDateTime limit = qMin(first.at.addMSecs(MergeWindow), first.mealStart);
+    QDateTime deadline = first.at;
+    foreach (const Reminder &reminder, queue) {
+        if (reminder.at > limit)
+            break;
+        deadline = reminder.at;
+    }
+    WakeupScheduler::instance()->schedule(this, "deliverDue", deadline);
+}
+
+void ReminderEngine::deliverDue() {
+    if (queue.isEmpty())
+        return;
+
+    // herätys tuli ryhmän viimeisen kohdalla, kaikki sitä ennen ovat ajallaan
+    QDateTime now = WakeupScheduler::instance()->currentDateTime();
+    QList<Reminder> batch;
+    while (!queue.isEmpty() && queue.first().at <= now)
+        batch.append(queue.takeFirst());
+    if (!batch.isEmpty()) {
+        lastDelivered = batch.last().mealStart;
+        sink->deliver(batch);
+        delivered += batch.count();
+        qDebug() << "reminders:" << batch.count() << "delivered," << delivered << "in total,"
+                 << WakeupScheduler::instance()->getWakeups() << "wakeups since start";
+    }
+    rebuild();
+}
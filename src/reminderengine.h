@@ -0,0 +1,51 @@
+#ifndef REMINDERENGINE_H
+#define REMINDERENGINE_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QScopedPointer>
+#include "remindersink.h"
+
+class QFoodCalendar;
+class MealConfig;
+
+// Heads-up a few minutes before each meal. The next few reminders are
+// computed from the calendar's meal index into a queue sorted by time. A
+// meal whose reminder time has passed but which has not started yet is
+// reminded of at once, so a rebuild inside the lead window does not lose
+// it. Reminders within MergeWindow of the first one due share a wakeup at
+// the latest of them (never past the first meal's start), so none is
+// delivered early. The queue is rebuilt whenever the menu, the meal times
+// or the lead time change. Wakeups and the time come from the
+// WakeupScheduler, so nothing runs between reminders.
+class ReminderEngine : public QObject
+{
+    Q_OBJECT
+public:
+    // omistaa sinkin
+    ReminderEngine(QFoodCalendar *calendar, MealConfig *config, ReminderSink *sink, QObject *parent = 0);
+
+    inline const QList<Reminder> &getQueue() const {
+        return queue;
+    }
+
+public slots:
+    void rebuild();
+
+private slots:
+    void deliverDue();
+
+private:
+    static const int QueueLength = 8;
+    static const int MergeWindow = 10 * 60 * 1000;
+
+    QPointer<QFoodCalendar> calendar;
+    QPointer<MealConfig> config;
+    QScopedPointer<ReminderSink> sink;
+    QList<Reminder> queue;
+    QDateTime lastDelivered;
+    int delivered;
+};
+
+#endif // REMINDERENGINE_H
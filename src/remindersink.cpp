@@ -0,0 +1,37 @@
+#include "remindersink.h"
+#include "mealschedule.h"
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QStringList>
+#include <QVariantMap>
+#include <QDebug>
+
+static QString reminderLine(const Reminder &reminder) {
+    QString line = MealSchedule::slotTitle(reminder.slot) + ' ' + reminder.mealStart.toString("H:mm");
+    if (!reminder.text.isEmpty())
+        line += ": " + reminder.text;
+    return line;
+}
+
+void LogReminderSink::deliver(const QList<Reminder> &reminders) {
+    foreach (const Reminder &reminder, reminders)
+        qDebug() << "reminder:" << reminderLine(reminder);
+}
+
+void NotificationReminderSink::deliver(const QList<Reminder> &reminders) {
+    if (reminders.isEmpty())
+        return;
+
+    QStringList lines;
+    foreach (const Reminder &reminder, reminders)
+        lines.append(reminderLine(reminder));
+
+    QDBusMessage notify = QDBusMessage::createMethodCall("org.freedesktop.Notifications",
+                                                         "/org/freedesktop/Notifications",
+                                                         "org.freedesktop.Notifications", "Notify");
+    notify << QString("SotkuMuija") << uint(0) << QString("icon-m-sotkumuija")
+           << MealSchedule::slotTitle(reminders.first().slot) << lines.join("\n")
+           << QStringList() << QVariantMap() << int(-1);
+    // ei jäädä odottamaan vastausta
+    QDBusConnection::sessionBus().asyncCall(notify);
+}
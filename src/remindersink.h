@@ -0,0 +1,39 @@
+#ifndef REMINDERSINK_H
+#define REMINDERSINK_H
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+struct Reminder
+{
+    QDateTime at;
+    QDateTime mealStart;
+    int slot;
+    QString text;
+};
+
+// Where due reminders go. Reminders that fall close together arrive as one
+// batch.
+class ReminderSink
+{
+public:
+    virtual ~ReminderSink() {}
+    virtual void deliver(const QList<Reminder> &reminders) = 0;
+};
+
+// qDebug only, for testing the timing without a notification daemon
+class LogReminderSink : public ReminderSink
+{
+public:
+    void deliver(const QList<Reminder> &reminders);
+};
+
+// org.freedesktop.Notifications on the session bus, one bubble per batch
+class NotificationReminderSink : public ReminderSink
+{
+public:
+    void deliver(const QList<Reminder> &reminders);
+};
+
+#endif // REMINDERSINK_H
@@ -0,0 +1,43 @@
+#include "roster.h"
+
+int RosterEntry::leaveDays(const QDate &from, const QDate &to) const {
+    int days = 0;
+    foreach (const LeavePeriod &leave, leaves) {
+        QDate first = qMax(leave.first, from);
+        QDate last = qMin(leave.last, to);
+        if (first <= last)
+            days += first.daysTo(last) + 1;
+    }
+    return days;
+}
+
+Roster::Roster(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void Roster::reserve(int size) {
+    entries.reserve(size);
+}
+
+int Roster::append(const RosterEntry &entry) {
+    entries.append(entry);
+    int index = entries.count() - 1;
+    emit entryAdded(index);
+    return index;
+}
+
+void Roster::update(int index, const RosterEntry &entry) {
+    QDate previousEndDate = entries.at(index).endDate();
+    entries[index] = entry;
+    emit entryChanged(index, previousEndDate);
+}
+
+void Roster::clear() {
+    entries.clear();
+    emit cleared();
+}
+
+int Roster::morningsLeft(int index, const QDate &today) const {
+    return morningsLeft(entries.at(index), today);
+}
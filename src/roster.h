@@ -0,0 +1,77 @@
+#ifndef ROSTER_H
+#define ROSTER_H
+
+#include <QObject>
+#include <QDate>
+#include <QString>
+#include <QVector>
+
+struct LeavePeriod
+{
+    QDate first;
+    QDate last;
+};
+
+struct RosterEntry
+{
+    RosterEntry() : serviceDays(0) {}
+
+    QString name;
+    QDate startDate;
+    int serviceDays;
+    QVector<LeavePeriod> leaves;
+
+    // kotiutuspäivä, palvelusaikaan lasketaan myös saapumispäivä
+    inline QDate endDate() const {
+        return startDate.addDays(serviceDays - 1);
+    }
+
+    // lomapäivät välillä from..to, molemmat mukaan lukien
+    int leaveDays(const QDate &from, const QDate &to) const;
+};
+
+Q_DECLARE_TYPEINFO(LeavePeriod, Q_MOVABLE_TYPE);
+
+class Roster : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Roster(QObject *parent = 0);
+
+    inline int count() const {
+        return entries.count();
+    }
+
+    inline const RosterEntry &entry(int index) const {
+        return entries.at(index);
+    }
+
+    void reserve(int size);
+    int append(const RosterEntry &entry);
+    void update(int index, const RosterEntry &entry);
+    void clear();
+
+    int morningsLeft(int index, const QDate &today) const;
+
+    // same rule as TjCalculatorBackend: the last morning counts too
+    static inline int morningsLeft(const QDate &endDate, const QDate &today) {
+        return today.daysTo(endDate) + 1;
+    }
+
+    // mornings still to wake up in the garrison: leave days ahead are
+    // subtracted, the end date itself does not move
+    static inline int morningsLeft(const RosterEntry &entry, const QDate &today) {
+        QDate endDate = entry.endDate();
+        return morningsLeft(endDate, today) - entry.leaveDays(today, endDate);
+    }
+
+signals:
+    void entryAdded(int index);
+    void entryChanged(int index, const QDate &previousEndDate);
+    void cleared();
+
+private:
+    QVector<RosterEntry> entries;
+};
+
+#endif // ROSTER_H
@@ -0,0 +1,443 @@
+#include "rosterimporter.h"
+#include "roster.h"
+#include <QFile>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <string.h>
+
+static const qint64 ChunkSize = 64 * 1024;
+
+static inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static const char *skipSpaces(const char *p, const char *end) {
+    while (p < end && isSpace(*p))
+        ++p;
+    return p;
+}
+
+static const char *trimEnd(const char *begin, const char *end) {
+    while (end > begin && isSpace(end[-1]))
+        --end;
+    return end;
+}
+
+static bool parseNumber(const char *&p, const char *end, int &value) {
+    const char *start = p;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9' && p - start < 9)
+        value = value * 10 + (*p++ - '0');
+    return p != start;
+}
+
+// d.m.yyyy tai yyyy-mm-dd, p siirtyy päivämäärän perään
+static bool parseDate(const char *&p, const char *end, QDate &date) {
+    p = skipSpaces(p, end);
+    int a, b, c;
+    if (!parseNumber(p, end, a) || p == end)
+        return false;
+    const char separator = *p;
+    if (separator != '.' && separator != '-')
+        return false;
+    ++p;
+    if (!parseNumber(p, end, b) || p == end || *p != separator)
+        return false;
+    ++p;
+    if (!parseNumber(p, end, c))
+        return false;
+    date = separator == '.' ? QDate(c, b, a) : QDate(a, b, c);
+    return date.isValid();
+}
+
+// "3.3.2014-7.3.2014;5.5.2014-9.5.2014" tai "2014-03-03..2014-03-07"
+static bool parseLeaves(const char *p, const char *end, QVector<LeavePeriod> &leaves) {
+    for (;;) {
+        p = skipSpaces(p, end);
+        if (p == end)
+            return true;
+        LeavePeriod leave;
+        if (!parseDate(p, end, leave.first))
+            return false;
+        p = skipSpaces(p, end);
+        if (end - p >= 2 && p[0] == '.' && p[1] == '.')
+            p += 2;
+        else if (p < end && *p == '-')
+            ++p;
+        else
+            return false;
+        if (!parseDate(p, end, leave.last) || leave.last < leave.first)
+            return false;
+        leaves.append(leave);
+        p = skipSpaces(p, end);
+        if (p < end && *p != ';')
+            return false;
+        if (p < end)
+            ++p;
+    }
+}
+
+// "1/14", "II/14" tai "2/2014"
+static bool parseBatch(const char *p, const char *end, QDate &startDate) {
+    p = skipSpaces(p, end);
+    end = trimEnd(p, end);
+    int batch = 0;
+    if (!parseNumber(p, end, batch)) {
+        while (p < end && *p == 'I') {
+            ++batch;
+            ++p;
+        }
+    }
+    if (p == end || *p != '/')
+        return false;
+    ++p;
+    const char *yearStart = p;
+    int year;
+    if (!parseNumber(p, end, year) || p != end)
+        return false;
+    if (p - yearStart <= 2)
+        year += 2000;
+    startDate = RosterImporter::arrivalDate(batch, year);
+    return startDate.isValid();
+}
+
+static bool parseServiceDays(const char *p, const char *end, int &days) {
+    p = skipSpaces(p, end);
+    return parseNumber(p, end, days) && skipSpaces(p, end) == end && days > 0;
+}
+
+// osoittaa lainausmerkin perään, 0 jos merkkijono jatkuu seuraavaan palaan
+static const char *skipJsonString(const char *p, const char *end) {
+    for (++p; p < end; ++p) {
+        if (*p == '\\')
+            ++p;
+        else if (*p == '"')
+            return p + 1;
+    }
+    return 0;
+}
+
+static const char *skipJsonValue(const char *p, const char *end) {
+    if (p == end)
+        return 0;
+    if (*p == '"')
+        return skipJsonString(p, end);
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        while (p < end) {
+            if (*p == '"') {
+                p = skipJsonString(p, end);
+                if (!p)
+                    return 0;
+                continue;
+            }
+            if (*p == '{' || *p == '[')
+                ++depth;
+            else if ((*p == '}' || *p == ']') && --depth == 0)
+                return p + 1;
+            ++p;
+        }
+        return 0;
+    }
+    while (p < end && *p != ',' && *p != '}' && *p != ']')
+        ++p;
+    return p;
+}
+
+static QString decodeJsonString(const char *begin, const char *end) {
+    if (!memchr(begin, '\\', end - begin))
+        return QString::fromUtf8(begin, end - begin);
+
+    QString result;
+    const char *run = begin;
+    for (const char *p = begin; p < end; ++p) {
+        if (*p != '\\')
+            continue;
+        result += QString::fromUtf8(run, p - run);
+        if (++p == end)
+            break;
+        switch (*p) {
+        case 'n': result += QLatin1Char('\n'); break;
+        case 't': result += QLatin1Char('\t'); break;
+        case 'u':
+            if (end - p > 4) {
+                result += QChar(QByteArray(p + 1, 4).toUShort(0, 16));
+                p += 4;
+            }
+            break;
+        default: result += QLatin1Char(*p); break;
+        }
+        run = p + 1;
+    }
+    result += QString::fromUtf8(run, end - run);
+    return result;
+}
+
+static inline bool keyIs(const char *begin, const char *end, const char *key) {
+    int length = strlen(key);
+    return end - begin == length && memcmp(begin, key, length) == 0;
+}
+
+RosterImporter::RosterImporter(QObject *parent) :
+    QObject(parent), roster(0), format(AutoDetect), rows(0), skipped(0), headerChecked(false)
+{
+}
+
+// saapumiserä I alkaa tammikuun ja erä II heinäkuun ensimmäisenä maanantaina
+QDate RosterImporter::arrivalDate(int batch, int year) {
+    if (batch != 1 && batch != 2)
+        return QDate();
+    QDate date(year, batch == 1 ? 1 : 7, 1);
+    return date.addDays((Qt::Monday - date.dayOfWeek() + 7) % 7);
+}
+
+bool RosterImporter::importFile(const QString &fileName, Roster *target, Format fileFormat) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "roster import: cannot open" << fileName << file.errorString();
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    roster = target;
+    format = fileFormat;
+    rows = 0;
+    skipped = 0;
+    headerChecked = false;
+
+    const qint64 size = file.size();
+    QByteArray head = file.peek(64);
+    qint64 offset = head.startsWith("\xEF\xBB\xBF") ? 3 : 0;
+    if (format == AutoDetect) {
+        const char *p = skipSpaces(head.constData() + offset, head.constData() + head.size());
+        format = p < head.constData() + head.size() && (*p == '[' || *p == '{') ? Json : Csv;
+    }
+
+    // noin 40 tavua riviä kohden
+    roster->reserve(roster->count() + int(size / 40));
+
+    if (uchar *map = file.map(0, size)) {
+        const char *data = reinterpret_cast<const char *>(map);
+        qint64 pos = offset;
+        qint64 window = ChunkSize;
+        while (pos < size) {
+            qint64 stop = qMin(pos + window, size);
+            int used = consume(data + pos, data + stop, stop == size);
+            if (used == 0 && stop < size) {
+                // rivi on pidempi kuin ikkuna
+                window += ChunkSize;
+                continue;
+            }
+            window = ChunkSize;
+            pos += used;
+            emit progress(pos, size);
+            if (stop == size)
+                break;
+        }
+        file.unmap(map);
+    } else {
+        QByteArray buffer;
+        buffer.reserve(2 * ChunkSize);
+        file.seek(offset);
+        qint64 pos = offset;
+        while (!file.atEnd() || !buffer.isEmpty()) {
+            QByteArray chunk = file.read(ChunkSize);
+            if (chunk.isEmpty() && !file.atEnd())
+                break;
+            pos += chunk.size();
+            buffer.append(chunk);
+            bool atEnd = file.atEnd();
+            int used = consume(buffer.constData(), buffer.constData() + buffer.size(), atEnd);
+            buffer.remove(0, used);
+            emit progress(pos, size);
+            if (atEnd)
+                break;
+        }
+    }
+
+    qint64 msecs = timer.elapsed();
+    qDebug() << "roster import:" << rows << "rows," << skipped << "skipped in" << msecs << "ms"
+             << (msecs > 0 ? qint64(rows) * 1000 / msecs : qint64(rows)) << "rows/s";
+    emit finished(rows, msecs);
+    roster = 0;
+    return true;
+}
+
+int RosterImporter::consume(const char *begin, const char *end, bool atEnd) {
+    return format == Json ? consumeJson(begin, end, atEnd) : consumeCsv(begin, end, atEnd);
+}
+
+int RosterImporter::consumeCsv(const char *begin, const char *end, bool atEnd) {
+    const char *p = begin;
+    while (p < end) {
+        const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!newline && !atEnd)
+            break;
+        const char *lineEnd = newline ? newline : end;
+        const char *lineBegin = skipSpaces(p, lineEnd);
+        p = newline ? newline + 1 : end;
+        if (lineBegin == lineEnd)
+            continue;
+
+        if (!headerChecked) {
+            headerChecked = true;
+            if (lineEnd - lineBegin >= 4
+                    && (qstrnicmp(lineBegin, "name", 4) == 0 || qstrnicmp(lineBegin, "nimi", 4) == 0))
+                continue;
+        }
+
+        RosterEntry entry;
+        if (parseCsvLine(lineBegin, trimEnd(lineBegin, lineEnd), entry))
+            commit(entry);
+        else
+            ++skipped;
+    }
+    return p - begin;
+}
+
+bool RosterImporter::parseCsvLine(const char *begin, const char *end, RosterEntry &entry) const {
+    const char *fields[4][2];
+    int count = 0;
+    const char *p = begin;
+    while (count < 4) {
+        p = skipSpaces(p, end);
+        const char *fieldBegin = p;
+        if (p < end && *p == '"') {
+            // lainausmerkeissä oleva nimi voi sisältää pilkkuja
+            for (++p; p < end; ++p) {
+                if (*p == '"' && (p + 1 == end || p[1] != '"'))
+                    break;
+                if (*p == '"')
+                    ++p;
+            }
+            if (p < end)
+                ++p;
+        }
+        const char *comma = count < 3 ? static_cast<const char *>(memchr(p, ',', end - p)) : 0;
+        const char *fieldEnd = comma ? comma : end;
+        fields[count][0] = fieldBegin;
+        fields[count][1] = trimEnd(fieldBegin, fieldEnd);
+        ++count;
+        if (!comma)
+            break;
+        p = comma + 1;
+    }
+    if (count < 3)
+        return false;
+
+    const char *nameBegin = fields[0][0];
+    const char *nameEnd = fields[0][1];
+    if (nameEnd - nameBegin >= 2 && *nameBegin == '"' && nameEnd[-1] == '"') {
+        QByteArray quoted(nameBegin + 1, nameEnd - nameBegin - 2);
+        entry.name = QString::fromUtf8(quoted.replace("\"\"", "\""));
+    } else {
+        entry.name = QString::fromUtf8(nameBegin, nameEnd - nameBegin);
+    }
+
+    if (!parseBatch(fields[1][0], fields[1][1], entry.startDate))
+        return false;
+    if (!parseServiceDays(fields[2][0], fields[2][1], entry.serviceDays))
+        return false;
+    if (count == 4 && !parseLeaves(fields[3][0], fields[3][1], entry.leaves))
+        return false;
+    return !entry.name.isEmpty();
+}
+
+int RosterImporter::consumeJson(const char *begin, const char *end, bool atEnd) {
+    const char *p = begin;
+    for (;;) {
+        while (p < end && (isSpace(*p) || *p == '[' || *p == ',' || *p == ']'))
+            ++p;
+        if (p == end)
+            break;
+        if (*p != '{') {
+            ++p;
+            continue;
+        }
+        const char *objectEnd = skipJsonValue(p, end);
+        if (!objectEnd) {
+            if (atEnd) {
+                ++skipped;
+                p = end;
+            }
+            break;
+        }
+        RosterEntry entry;
+        if (parseJsonObject(p + 1, objectEnd - 1, entry))
+            commit(entry);
+        else
+            ++skipped;
+        p = objectEnd;
+    }
+    return p - begin;
+}
+
+bool RosterImporter::parseJsonObject(const char *p, const char *end, RosterEntry &entry) const {
+    bool hasBatch = false;
+    bool hasService = false;
+    for (;;) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == ',')
+            p = skipSpaces(p + 1, end);
+        if (p == end)
+            break;
+        if (*p != '"')
+            return false;
+        const char *keyEnd = skipJsonString(p, end);
+        if (!keyEnd)
+            return false;
+        const char *keyBegin = p + 1;
+        p = skipSpaces(keyEnd, end);
+        if (p == end || *p != ':')
+            return false;
+        p = skipSpaces(p + 1, end);
+        const char *valueEnd = skipJsonValue(p, end);
+        if (!valueEnd)
+            return false;
+
+        const char *valueBegin = p;
+        const char *valueLast = valueEnd;
+        if (*p == '"') {
+            ++valueBegin;
+            --valueLast;
+        }
+
+        if (keyIs(keyBegin, keyEnd - 1, "name")) {
+            entry.name = decodeJsonString(valueBegin, valueLast);
+        } else if (keyIs(keyBegin, keyEnd - 1, "batch")) {
+            if (!parseBatch(valueBegin, valueLast, entry.startDate))
+                return false;
+            hasBatch = true;
+        } else if (keyIs(keyBegin, keyEnd - 1, "service")) {
+            if (!parseServiceDays(valueBegin, trimEnd(valueBegin, valueLast), entry.serviceDays))
+                return false;
+            hasService = true;
+        } else if (keyIs(keyBegin, keyEnd - 1, "leaves")) {
+            if (*p == '[') {
+                const char *item = p + 1;
+                for (;;) {
+                    item = skipSpaces(item, valueEnd - 1);
+                    if (item < valueEnd - 1 && *item == ',')
+                        item = skipSpaces(item + 1, valueEnd - 1);
+                    if (item >= valueEnd - 1)
+                        break;
+                    const char *itemEnd = skipJsonValue(item, valueEnd - 1);
+                    if (!itemEnd || *item != '"' || !parseLeaves(item + 1, itemEnd - 1, entry.leaves))
+                        return false;
+                    item = itemEnd;
+                }
+            } else if (!parseLeaves(valueBegin, valueLast, entry.leaves)) {
+                return false;
+            }
+        }
+        p = valueEnd;
+    }
+    return hasBatch && hasService && !entry.name.isEmpty();
+}
+
+void RosterImporter::commit(const RosterEntry &entry) {
+    roster->append(entry);
+    ++rows;
+}
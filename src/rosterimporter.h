@@ -0,0 +1,59 @@
+#ifndef ROSTERIMPORTER_H
+#define ROSTERIMPORTER_H
+
+#include <QObject>
+#include <QDate>
+#include <QString>
+
+class Roster;
+struct RosterEntry;
+
+// Reads a roster file incrementally (mapped when possible, otherwise in
+// fixed-size chunks) and appends every row straight into a Roster.
+//
+// CSV:  name,batch,service,leaves     e.g. Virtanen,1/14,165,3.3.2014-7.3.2014;5.5.2014-9.5.2014
+// JSON: [{"name": "Virtanen", "batch": "1/14", "service": 165, "leaves": "3.3.2014-7.3.2014"}, ...]
+class RosterImporter : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format {
+        AutoDetect,
+        Csv,
+        Json
+    };
+
+    explicit RosterImporter(QObject *parent = 0);
+
+    bool importFile(const QString &fileName, Roster *roster, Format format = AutoDetect);
+
+    inline int importedRows() const {
+        return rows;
+    }
+
+    inline int skippedRows() const {
+        return skipped;
+    }
+
+    static QDate arrivalDate(int batch, int year);
+
+signals:
+    void progress(qint64 bytesRead, qint64 bytesTotal);
+    void finished(int rows, qint64 msecs);
+
+private:
+    int consume(const char *begin, const char *end, bool atEnd);
+    int consumeCsv(const char *begin, const char *end, bool atEnd);
+    int consumeJson(const char *begin, const char *end, bool atEnd);
+    bool parseCsvLine(const char *begin, const char *end, RosterEntry &entry) const;
+    bool parseJsonObject(const char *begin, const char *end, RosterEntry &entry) const;
+    void commit(const RosterEntry &entry);
+
+    Roster *roster;
+    Format format;
+    int rows;
+    int skipped;
+    bool headerChecked;
+};
+
+#endif // ROSTERIMPORTER_H
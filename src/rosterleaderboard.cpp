@@ -0,0 +1,187 @@
+#include "rosterleaderboard.h"
+#include "roster.h"
+#include "wakeupscheduler.h"
+#include <limits.h>
+
+RosterLeaderboard::RosterLeaderboard(Roster *roster, QObject *parent) :
+    QAbstractListModel(parent), roster(roster), today(QDate::currentDate()), limit(0), visibleRows(0), active(true)
+{
+    connect(roster, SIGNAL(entryAdded(int)), this, SLOT(entryAdded(int)));
+    connect(roster, SIGNAL(entryChanged(int,QDate)), this, SLOT(entryChanged(int,QDate)));
+    connect(roster, SIGNAL(cleared()), this, SLOT(rebuild()));
+    rebuild();
+    nextDay();
+}
+
+void RosterLeaderboard::setLimit(int value) {
+    if (value == limit)
+        return;
+    beginResetModel();
+    limit = qMax(0, value);
+    visibleRows = qMin(tree.count(), visibleLimit());
+    endResetModel();
+    emit limitChanged();
+}
+
+void RosterLeaderboard::setToday(const QDate &date) {
+    if (date == today)
+        return;
+    today = date;
+    // järjestys ei muutu, vain jäljellä olevat aamut
+    if (visibleRows > 0)
+        emit dataChanged(index(0), index(visibleRows - 1), QVector<int>() << MorningsLeftRole << MorningsLeftTextRole);
+    emit todayChanged();
+}
+
+int RosterLeaderboard::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : visibleRows;
+}
+
+QVariant RosterLeaderboard::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= visibleRows)
+        return QVariant();
+
+    qint64 key = tree.select(index.row());
+    int person = int(key & 0xffffffff);
+    const RosterEntry &entry = roster->entry(person);
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return entry.name;
+    case MorningsLeftRole:
+        return Roster::morningsLeft(entry, today);
+    case MorningsLeftTextRole:
+        return plural.format(Roster::morningsLeft(entry, today), PluralFormatter::Morning);
+    case RankRole:
+        return rankOfKey(key);
+    case PersonRole:
+        return person;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> RosterLeaderboard::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[MorningsLeftRole] = "morningsLeft";
+    roles[MorningsLeftTextRole] = "morningsLeftText";
+    roles[RankRole] = "rank";
+    roles[PersonRole] = "person";
+    return roles;
+}
+
+int RosterLeaderboard::rankOf(int person) const {
+    if (person < 0 || person >= roster->count())
+        return 0;
+    return rankOfKey(keyFor(roster->entry(person).endDate(), person));
+}
+
+int RosterLeaderboard::rankOfKey(qint64 key) const {
+    // saman päivän kotiutujat jakavat sijan
+    return tree.countLess(key & ~qint64(0xffffffff)) + 1;
+}
+
+void RosterLeaderboard::ranksChanged(int firstRow) {
+    if (firstRow < visibleRows)
+        emit dataChanged(index(firstRow), index(visibleRows - 1), QVector<int>() << RankRole);
+}
+
+int RosterLeaderboard::visibleLimit() const {
+    return limit > 0 ? limit : INT_MAX;
+}
+
+void RosterLeaderboard::entryAdded(int person) {
+    qint64 key = keyFor(roster->entry(person).endDate(), person);
+    int row = tree.countLess(key);
+    int maxRows = visibleLimit();
+
+    if (row >= maxRows) {
+        tree.insert(key);
+        return;
+    }
+    if (visibleRows == maxRows) {
+        // viimeinen näkyvä rivi putoaa listalta
+        beginRemoveRows(QModelIndex(), visibleRows - 1, visibleRows - 1);
+        --visibleRows;
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), row, row);
+    tree.insert(key);
+    ++visibleRows;
+    endInsertRows();
+    ranksChanged(row + 1);
+}
+
+void RosterLeaderboard::entryChanged(int person, const QDate &previousEndDate) {
+    qint64 oldKey = keyFor(previousEndDate, person);
+    qint64 newKey = keyFor(roster->entry(person).endDate(), person);
+    if (oldKey == newKey) {
+        int row = tree.countLess(oldKey);
+        if (row < visibleRows)
+            emit dataChanged(index(row), index(row));
+        return;
+    }
+
+    int oldRow = tree.countLess(oldKey);
+    int newRow = tree.countLess(newKey) - (oldKey < newKey ? 1 : 0);
+    int maxRows = visibleLimit();
+
+    if (oldRow < maxRows && newRow < maxRows) {
+        if (oldRow != newRow)
+            beginMoveRows(QModelIndex(), oldRow, oldRow, QModelIndex(), newRow > oldRow ? newRow + 1 : newRow);
+        tree.remove(oldKey);
+        tree.insert(newKey);
+        if (oldRow != newRow)
+            endMoveRows();
+        // väliin jäävien sijat voivat muuttua
+        emit dataChanged(index(qMin(oldRow, newRow)), index(qMax(oldRow, newRow)));
+    } else if (oldRow < maxRows) {
+        beginRemoveRows(QModelIndex(), oldRow, oldRow);
+        tree.remove(oldKey);
+        tree.insert(newKey);
+        --visibleRows;
+        endRemoveRows();
+        beginInsertRows(QModelIndex(), visibleRows, visibleRows);
+        ++visibleRows;
+        endInsertRows();
+        ranksChanged(oldRow);
+    } else if (newRow < maxRows) {
+        beginRemoveRows(QModelIndex(), visibleRows - 1, visibleRows - 1);
+        --visibleRows;
+        endRemoveRows();
+        beginInsertRows(QModelIndex(), newRow, newRow);
+        tree.remove(oldKey);
+        tree.insert(newKey);
+        ++visibleRows;
+        endInsertRows();
+        ranksChanged(newRow + 1);
+    } else {
+        tree.remove(oldKey);
+        tree.insert(newKey);
+    }
+}
+
+void RosterLeaderboard::setActive(bool value) {
+    if (value == active)
+        return;
+    active = value;
+    if (active)
+        nextDay();
+    else
+        WakeupScheduler::instance()->cancel(this, "nextDay");
+}
+
+// aamut vähenevät keskiyöllä
+void RosterLeaderboard::nextDay() {
+    setToday(QDate::currentDate());
+    WakeupScheduler::instance()->schedule(this, "nextDay", QDateTime(today.addDays(1)));
+}
+
+void RosterLeaderboard::rebuild() {
+    beginResetModel();
+    tree.clear();
+    for (int i = 0; i < roster->count(); ++i)
+        tree.insert(keyFor(roster->entry(i).endDate(), i));
+    visibleRows = qMin(tree.count(), visibleLimit());
+    endResetModel();
+}
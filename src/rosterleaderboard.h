@@ -0,0 +1,80 @@
+#ifndef ROSTERLEADERBOARD_H
+#define ROSTERLEADERBOARD_H
+
+#include <QAbstractListModel>
+#include <QDate>
+#include "orderstatistictree.h"
+#include "pluralformatter.h"
+
+class Roster;
+
+// Roster ordered by remaining mornings, fewest first. Entries are keyed by
+// their end date, so the order stays valid as days pass and only edited
+// entries have to move in the tree. The midnight wakeup is dropped while
+// the app is hidden and caught up on setActive(true).
+class RosterLeaderboard : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int limit READ getLimit WRITE setLimit NOTIFY limitChanged)
+    Q_PROPERTY(QDate today READ getToday WRITE setToday NOTIFY todayChanged)
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        MorningsLeftRole,
+        MorningsLeftTextRole,
+        RankRole,
+        PersonRole
+    };
+
+    explicit RosterLeaderboard(Roster *roster, QObject *parent = 0);
+
+    inline int getLimit() const {
+        return limit;
+    }
+    void setLimit(int limit);
+
+    inline const QDate &getToday() const {
+        return today;
+    }
+    void setToday(const QDate &date);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    // 1 + number of people with fewer mornings left
+    Q_INVOKABLE int rankOf(int person) const;
+
+public slots:
+    void setActive(bool active);
+
+signals:
+    void limitChanged();
+    void todayChanged();
+
+private slots:
+    void entryAdded(int index);
+    void entryChanged(int index, const QDate &previousEndDate);
+    void rebuild();
+    void nextDay();
+
+private:
+    static inline qint64 keyFor(const QDate &endDate, int person = 0) {
+        return (endDate.toJulianDay() << 32) | person;
+    }
+    int rankOfKey(qint64 key) const;
+    void ranksChanged(int firstRow);
+    int visibleLimit() const;
+
+    Roster *roster;
+    OrderStatisticTree tree;
+    QDate today;
+    PluralFormatter plural;
+    int limit;
+    int visibleRows;
+    bool active;
+};
+
+#endif // ROSTERLEADERBOARD_H
@@ -1,57 +1,193 @@
 #include "tjcalculatorbackend.h"
-#include "qtimespan.h"
+#include "tjcalculatorworker.h"
+#include "wakeupscheduler.h"
 #include <QDate>
 
+// tätä suurempi ero seinäkelloon lasketaan hypyksi
+static const qint64 LiveResyncThreshold = 2000;
 
-
+static inline void appendTwoDigits(QString &out, int value) {
+    out += QLatin1Char(char('0' + value / 10));
+    out += QLatin1Char(char('0' + value % 10));
+}
 
 TjCalculatorBackend::TjCalculatorBackend(QObject *parent) :
-    QObject(parent)
+    QObject(parent), snapshot(new TjSnapshot), mailbox(0), active(true), liveEnabled(false),
+    liveWallStart(0), liveNextTick(0), liveHours(0), liveMinutes(0), liveSeconds(0)
 {
     QDate date(2014, 1, 6);
     startDate = QDateTime(date);
     startDate.setTime(QTime(15,0));
-    tjInDays = "QString()";
+
+    worker = new TjCalculatorWorker(&mailbox);
+    worker->moveToThread(&workerThread);
+    connect(worker, SIGNAL(published()), this, SLOT(snapshotPublished()));
+    workerThread.setObjectName("tjcalc");
+    workerThread.start(QThread::LowPriority);
+
+    liveTimer.setSingleShot(true);
+    liveTimer.setTimerType(Qt::PreciseTimer);
+    connect(&liveTimer, SIGNAL(timeout()), this, SLOT(liveTick()));
+
     calculateTj();
 }
 
+TjCalculatorBackend::~TjCalculatorBackend() {
+    workerThread.quit();
+    workerThread.wait();
+    delete worker;
+    delete mailbox.fetchAndStoreOrdered(0);
+    delete snapshot;
+}
+
 void TjCalculatorBackend::calculateTj() {
+    QMetaObject::invokeMethod(worker, "calculate", Qt::QueuedConnection);
+}
+
+void TjCalculatorBackend::snapshotPublished() {
+    // useampi julkaisu voi ehtiä ennen kuin tämä ajetaan, uusin riittää
+    TjSnapshot *latest = mailbox.fetchAndStoreAcquire(0);
+    if (!latest)
+        return;
+
+    TjSnapshot *previous = snapshot;
+    snapshot = latest;
 
-    tjInDays = QString();
+    // piilossa ei herätä, näkyviin tultaessa lasketaan kerran uudelleen
+    if (active)
+        WakeupScheduler::instance()->schedule(this, "calculateTj", snapshot->nextUpdate);
 
-    QDateTime now = QDateTime::currentDateTime();
+    // tekstit ovat välimuistissa, vertailu muotoilee vain muuttuneet
+    QString days = getTjInDays();
+    QString months = getTjInMonths();
+    QString weeks = getTjInWeeks();
+    remaining.setSpan(snapshot->remaining);
+    if (getTjInDays() != days)
+        emit tjInDaysChanged();
+    if (getTjInMonths() != months)
+        emit tjInMonthsChanged();
+    if (getTjInWeeks() != weeks)
+        emit tjInWeeksChanged();
+    if (snapshot->daysDone != previous->daysDone)
+        emit daysDoneChanged();
+    delete previous;
+    emit calculated();
 
-    QDateTime endDate(QDate(2014,6,19));
-    endDate.setTime(QTime(15,0));
-    QTimeSpan span = endDate - now;
+    // kotiutuspäivä tiedetään vasta ensimmäisestä tuloksesta
+    if (isLive() && !liveTimer.isActive())
+        syncLive();
+}
 
+void TjCalculatorBackend::setActive(bool value) {
+    if (value == active)
+        return;
+    bool wasLive = isLive();
+    active = value;
+    if (active)
+        calculateTj();
+    else
+        WakeupScheduler::instance()->cancel(this, "calculateTj");
+    if (isLive() != wasLive)
+        updateLive();
+}
 
-    // pitää laskea kans viiminen päivä mukaan
-    int diffDays = (int)span.toDays() + 1;
-    daysDone = (qreal)(((qreal)PALVELUSAJAN_PITUUS - (qreal)diffDays) / (qreal)PALVELUSAJAN_PITUUS ) * 100.0f;
-    qDebug() << "tjcalc " <<  daysDone  << " wat?";
-    if (diffDays != 1) {
-        diffDays = qAbs(diffDays);
-        tjInDays = QString::number(diffDays);
-        tjInDays += diffDays == 1 ? " aamu" : " aamua";
+void TjCalculatorBackend::setLiveEnabled(bool enabled) {
+    if (enabled == liveEnabled)
+        return;
+    bool wasLive = isLive();
+    liveEnabled = enabled;
+    emit liveEnabledChanged();
+    if (isLive() != wasLive)
+        updateLive();
+}
 
-        tjInMonths = calculateTjInMonths(span);
-        tjInWeeks = calculateTjInWeeks(span);
+void TjCalculatorBackend::setLiveConsumer(QObject *consumer, bool visible) {
+    if (!consumer)
+        return;
+    bool wasLive = isLive();
+    if (visible && !liveConsumers.contains(consumer)) {
+        liveConsumers.insert(consumer);
+        connect(consumer, SIGNAL(destroyed(QObject*)), this, SLOT(liveConsumerDestroyed(QObject*)));
+    } else if (!visible && liveConsumers.remove(consumer)) {
+        disconnect(consumer, SIGNAL(destroyed(QObject*)), this, SLOT(liveConsumerDestroyed(QObject*)));
     }
+    if (isLive() != wasLive)
+        updateLive();
+}
+
+void TjCalculatorBackend::liveConsumerDestroyed(QObject *consumer) {
+    bool wasLive = isLive();
+    liveConsumers.remove(consumer);
+    if (isLive() != wasLive)
+        updateLive();
+}
+
+void TjCalculatorBackend::updateLive() {
+    if (isLive())
+        syncLive();
+    else
+        liveTimer.stop();
+    emit liveChanged();
+}
+
+// jaetaan osiin kerran seinäkellosta, sen jälkeen vain vähennetään
+void TjCalculatorBackend::syncLive() {
+    liveClock.start();
+    liveWallStart = QDateTime::currentMSecsSinceEpoch();
 
+    QDateTime endDate = snapshot->remaining.referencedDate();
+    qint64 msecs = endDate.isValid() ? qMax(Q_INT64_C(0), endDate.toMSecsSinceEpoch() - liveWallStart) : 0;
+    // näytetään kokonaiset sekunnit ylöspäin, 00:00:00 vasta perillä
+    qint64 secs = (msecs + 999) / 1000;
+    liveHours = int(secs / 3600);
+    liveMinutes = int(secs / 60 % 60);
+    liveSeconds = int(secs % 60);
+    liveNextTick = msecs % 1000 == 0 ? 1000 : msecs % 1000;
 
-    emit tjInDaysChanged();
-    emit tjInMonthsChanged();
+    formatCountdown();
+    if (secs > 0)
+        armLive();
+    else
+        liveTimer.stop();
 }
 
-QString TjCalculatorBackend::calculateTjInMonths(QTimeSpan &difference) {
-    qreal diffmonths = difference.toMonths();
-    QString monthstr = QString::number(diffmonths, 'f', 1);
+void TjCalculatorBackend::armLive() {
+    liveTimer.start(int(qMax(Q_INT64_C(0), liveNextTick - liveClock.elapsed())));
+}
+
+void TjCalculatorBackend::liveTick() {
+    qint64 elapsed = liveClock.elapsed();
+    qint64 wallElapsed = QDateTime::currentMSecsSinceEpoch() - liveWallStart;
+    // herätys myöhästyi tai kelloa siirrettiin, aloitetaan alusta
+    if (qAbs(wallElapsed - elapsed) > LiveResyncThreshold || elapsed - liveNextTick > LiveResyncThreshold) {
+        syncLive();
+        return;
+    }
 
-    return monthstr + (monthstr == "1" ? " kuukausi" : " kuukautta");
+    if (liveSeconds > 0) {
+        --liveSeconds;
+    } else if (liveMinutes > 0) {
+        --liveMinutes;
+        liveSeconds = 59;
+    } else if (liveHours > 0) {
+        --liveHours;
+        liveMinutes = 59;
+        liveSeconds = 59;
+    }
+    liveNextTick += 1000;
+
+    formatCountdown();
+    if (liveHours > 0 || liveMinutes > 0 || liveSeconds > 0)
+        armLive();
 }
-QString TjCalculatorBackend::calculateTjInWeeks(QTimeSpan &difference) {
-    qreal diffweeks = difference.toWeeks();
-    QString weekstr = QString::number(diffweeks, 'f', 1);
-    return weekstr + (weekstr == "1" ? " viikko" : " viikkoa");
+
+void TjCalculatorBackend::formatCountdown() {
+    // sama puskuri joka sekunti
+    countdown.resize(0);
+    countdown += QString::number(liveHours);
+    countdown += QLatin1Char(':');
+    appendTwoDigits(countdown, liveMinutes);
+    countdown += QLatin1Char(':');
+    appendTwoDigits(countdown, liveSeconds);
+    emit countdownChanged();
 }
@@ -2,35 +2,74 @@
 #define TJCALCULATORBACKEND_H
 
 
-#define PALVELUSAJAN_PITUUS 165
-
-
 #include <QObject>
 #include <QDateTime>
 #include <QString>
 #include <QDebug>
-#include "qtimespan.h"
-
+#include <QThread>
+#include <QAtomicPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSet>
+#include "tjsnapshot.h"
+#include "qtimespanvalue.h"
+
+class TjCalculatorWorker;
+
+// GUI thread facade for the countdown. The math runs in a worker thread;
+// this object only picks up the latest published snapshot and emits the
+// NOTIFY signals of whatever changed.
+//
+// The optional live countdown ("hh:mm:ss") is kept here instead. It is
+// decomposed once from wall time and then stepped down a second at a time
+// on the monotonic clock, aligned to the second boundary. Wall time is
+// only consulted again when the two clocks disagree by more than a couple
+// of seconds (suspend, clock change). It ticks only while liveEnabled is
+// set and at least one consumer has said it is visible.
+//
+// setActive(false) drops the day change wakeup and stops the live
+// countdown; setActive(true) recalculates once.
 class TjCalculatorBackend : public QObject
 {
     Q_OBJECT
 
     QDateTime startDate;
     //QDateTime endTime;
-    QString tjInDays;
-    QString tjInMonths;
-    QString tjInWeeks;
-    qreal daysDone;
+    TjSnapshot *snapshot;
+    QAtomicPointer<TjSnapshot> mailbox;
+    QThread workerThread;
+    TjCalculatorWorker *worker;
+    QTimeSpanValue remaining;
+
+    bool active;
+    bool liveEnabled;
+    QSet<QObject *> liveConsumers;
+    QTimer liveTimer;
+    QElapsedTimer liveClock;
+    qint64 liveWallStart;
+    qint64 liveNextTick;
+    int liveHours;
+    int liveMinutes;
+    int liveSeconds;
+    QString countdown;
     //void updateDiff();
 
     Q_PROPERTY(QDateTime startDate READ getStartDate WRITE setStartDate NOTIFY startDateChanged)
     Q_PROPERTY(QString tjInMonths READ getTjInMonths NOTIFY tjInMonthsChanged STORED false)
     Q_PROPERTY(QString tjInDays READ getTjInDays NOTIFY tjInDaysChanged STORED false)
     Q_PROPERTY(QString tjInWeeks READ getTjInWeeks NOTIFY tjInWeeksChanged STORED false)
-    Q_PROPERTY(qreal daysDone READ getDaysDone STORED false)
+    Q_PROPERTY(qreal daysDone READ getDaysDone NOTIFY daysDoneChanged STORED false)
+    Q_PROPERTY(QTimeSpanValue *remaining READ getRemaining CONSTANT)
+    Q_PROPERTY(bool liveEnabled READ isLiveEnabled WRITE setLiveEnabled NOTIFY liveEnabledChanged)
+    Q_PROPERTY(bool live READ isLive NOTIFY liveChanged)
+    Q_PROPERTY(QString countdown READ getCountdown NOTIFY countdownChanged)
+    Q_PROPERTY(int liveHours READ getLiveHours NOTIFY countdownChanged)
+    Q_PROPERTY(int liveMinutes READ getLiveMinutes NOTIFY countdownChanged)
+    Q_PROPERTY(int liveSeconds READ getLiveSeconds NOTIFY countdownChanged)
 
 public:
     TjCalculatorBackend(QObject *parent = 0);
+    ~TjCalculatorBackend();
 
     inline const QDateTime &getStartDate() const {
         return startDate;
@@ -39,32 +78,86 @@ public:
         startDate = dateTime;
     }
 
-    inline const QString &getTjInDays() const {
-        return tjInDays;
+    // kioskille ja D-Busille, QML käyttää suoraan remaining.text():iä
+    inline QString getTjInDays() const {
+        return remaining.text(QTimeSpanValue::Mornings);
     }
 
-    inline const QString &getTjInMonths() const {
-        return tjInMonths;
+    inline QString getTjInMonths() const {
+        return remaining.text(QTimeSpanValue::Months, 1);
     }
 
     inline const qreal &getDaysDone() const {
-        return daysDone;
+        return snapshot->daysDone;
+    }
+
+    inline QString getTjInWeeks() const {
+        return remaining.text(QTimeSpanValue::Weeks, 1);
+    }
+
+    // seuraava hetki jolloin aamujen määrä vaihtuu
+    inline const QDateTime &getNextUpdate() const {
+        return snapshot->nextUpdate;
+    }
+
+    // QML sitoo lukuihin ja muotoilee vain näkyvän tekstin
+    inline QTimeSpanValue *getRemaining() {
+        return &remaining;
+    }
+
+    inline const TjSnapshot &getSnapshot() const {
+        return *snapshot;
     }
 
-    inline const QString &getTjInWeeks() const {
-        return tjInWeeks;
+    inline bool isLiveEnabled() const {
+        return liveEnabled;
     }
+    void setLiveEnabled(bool enabled);
 
+    inline bool isLive() const {
+        return active && liveEnabled && !liveConsumers.isEmpty();
+    }
+
+    inline const QString &getCountdown() const {
+        return countdown;
+    }
+    inline int getLiveHours() const {
+        return liveHours;
+    }
+    inline int getLiveMinutes() const {
+        return liveMinutes;
+    }
+    inline int getLiveSeconds() const {
+        return liveSeconds;
+    }
+
+    // sivu ja kansi kertovat ovatko ne näkyvissä
+    Q_INVOKABLE void setLiveConsumer(QObject *consumer, bool visible);
+
+public slots:
     void calculateTj();
-private:
-    QString calculateTjInMonths(QTimeSpan &difference);
-    QString calculateTjInWeeks(QTimeSpan &difference);
+    void setActive(bool active);
+private slots:
+    void snapshotPublished();
+    void liveTick();
+    void liveConsumerDestroyed(QObject *consumer);
 signals:
     void startDateChanged();
 
     void tjInDaysChanged();
     void tjInMonthsChanged();
     void tjInWeeksChanged();
+    void daysDoneChanged();
+    void calculated();
+    void liveEnabledChanged();
+    void liveChanged();
+    void countdownChanged();
+
+private:
+    void updateLive();
+    void syncLive();
+    void armLive();
+    void formatCountdown();
 };
 
 #endif // TJCALCULATORBACKEND_H
@@ -0,0 +1,34 @@
+#include "tjcalculatorworker.h"
+#include <QDate>
+#include <QDebug>
+
+TjCalculatorWorker::TjCalculatorWorker(QAtomicPointer<TjSnapshot> *mailbox, QObject *parent) :
+    QObject(parent), mailbox(mailbox)
+{
+}
+
+void TjCalculatorWorker::calculate() {
+    TjSnapshot *snapshot = new TjSnapshot;
+
+    QDateTime now = QDateTime::currentDateTime();
+
+    QDateTime endDate(QDate(2014,6,19));
+    endDate.setTime(QTime(15,0));
+    QTimeSpan span = endDate - now;
+    // tekstit muotoillaan vasta kun joku niitä lukee, ks. QTimeSpanValue
+    snapshot->remaining = span;
+
+
+    // pitää laskea kans viiminen päivä mukaan
+    int diffDays = (int)span.toDays() + 1;
+    snapshot->daysDone = (qreal)(((qreal)PALVELUSAJAN_PITUUS - (qreal)diffDays) / (qreal)PALVELUSAJAN_PITUUS ) * 100.0f;
+    qDebug() << "tjcalc " <<  snapshot->daysDone  << " wat?";
+
+    // päivä vaihtuu kun span ylittää seuraavan kokonaisen päivän
+    snapshot->nextUpdate = endDate.addDays(-(int)span.toDays());
+    if (snapshot->nextUpdate <= now)
+        snapshot->nextUpdate = snapshot->nextUpdate.addDays(1);
+
+    delete mailbox->fetchAndStoreOrdered(snapshot);
+    emit published();
+}
@@ -0,0 +1,31 @@
+#ifndef TJCALCULATORWORKER_H
+#define TJCALCULATORWORKER_H
+
+#include <QObject>
+#include <QAtomicPointer>
+#include "tjsnapshot.h"
+#include "qtimespan.h"
+
+#define PALVELUSAJAN_PITUUS 165
+
+// Does the actual countdown math in the calculator thread. Each result is
+// a fresh TjSnapshot handed over through a single-slot mailbox: the worker
+// swaps its snapshot in, the GUI thread swaps it out. A snapshot that the
+// GUI thread never collected is freed by the worker on the next swap.
+class TjCalculatorWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TjCalculatorWorker(QAtomicPointer<TjSnapshot> *mailbox, QObject *parent = 0);
+
+public slots:
+    void calculate();
+
+signals:
+    void published();
+
+private:
+    QAtomicPointer<TjSnapshot> *mailbox;
+};
+
+#endif // TJCALCULATORWORKER_H
@@ -0,0 +1,26 @@
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDebug>
+#include "tjcalculatorbackend.h"
+#include "tjdbusadaptor.h"
+
+// Headless countdown service, started on demand by the session bus.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    TjCalculatorBackend backend;
+    new TjDBusAdaptor(&backend);
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.registerObject(TJ_DBUS_PATH, &backend)) {
+        qWarning() << "tjd: cannot register object:" << bus.lastError().message();
+        return 1;
+    }
+    if (!bus.registerService(TJ_DBUS_SERVICE)) {
+        qWarning() << "tjd: cannot register service:" << bus.lastError().message();
+        return 1;
+    }
+    return app.exec();
+}
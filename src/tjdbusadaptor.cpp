@@ -0,0 +1,15 @@
+#include "tjdbusadaptor.h"
+
+TjDBusAdaptor::TjDBusAdaptor(TjCalculatorBackend *backend) :
+    QDBusAbstractAdaptor(backend), backend(backend)
+{
+    connect(backend, SIGNAL(calculated()), this, SLOT(backendCalculated()));
+}
+
+void TjDBusAdaptor::Refresh() {
+    backend->calculateTj();
+}
+
+void TjDBusAdaptor::backendCalculated() {
+    emit Changed(tjInDays(), tjInMonths(), tjInWeeks(), daysDone());
+}
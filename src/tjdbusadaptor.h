@@ -0,0 +1,54 @@
+#ifndef TJDBUSADAPTOR_H
+#define TJDBUSADAPTOR_H
+
+#include <QDBusAbstractAdaptor>
+#include "tjcalculatorbackend.h"
+
+#define TJ_DBUS_SERVICE "fi.sotkumuija.Tj"
+#define TJ_DBUS_PATH "/Tj"
+
+// Exports TjCalculatorBackend on the session bus so that the cover, other
+// apps and scripts can read the countdown without loading any QML.
+class TjDBusAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "fi.sotkumuija.Tj")
+
+    Q_PROPERTY(QString TjInDays READ tjInDays)
+    Q_PROPERTY(QString TjInMonths READ tjInMonths)
+    Q_PROPERTY(QString TjInWeeks READ tjInWeeks)
+    Q_PROPERTY(double DaysDone READ daysDone)
+
+public:
+    explicit TjDBusAdaptor(TjCalculatorBackend *backend);
+
+    inline QString tjInDays() const {
+        return backend->getTjInDays();
+    }
+
+    inline QString tjInMonths() const {
+        return backend->getTjInMonths();
+    }
+
+    inline QString tjInWeeks() const {
+        return backend->getTjInWeeks();
+    }
+
+    inline double daysDone() const {
+        return backend->getDaysDone();
+    }
+
+public slots:
+    void Refresh();
+
+signals:
+    void Changed(const QString &tjInDays, const QString &tjInMonths, const QString &tjInWeeks, double daysDone);
+
+private slots:
+    void backendCalculated();
+
+private:
+    TjCalculatorBackend *backend;
+};
+
+#endif // TJDBUSADAPTOR_H
@@ -0,0 +1,24 @@
+#ifndef TJSNAPSHOT_H
+#define TJSNAPSHOT_H
+
+#include <QString>
+#include <QDateTime>
+#include "qtimespan.h"
+
+// Immutable result of one countdown calculation. Built on the worker
+// thread and never modified after it has been published.
+//
+// The current meal is not part of it: QFoodCalendar answers that with a
+// MealIndex lookup on the GUI thread, woken only at meal changes, and the
+// model and its pool are not shared with this thread.
+struct TjSnapshot
+{
+    TjSnapshot() : daysDone(0) {}
+
+    qreal daysDone;
+    QDateTime nextUpdate;
+    // laskentahetkestä kotiutumiseen
+    QTimeSpan remaining;
+};
+
+#endif // TJSNAPSHOT_H
@@ -0,0 +1,64 @@
+#include "visibilitytracker.h"
+#include <QDebug>
+#include <time.h>
+
+// ennen kuin QML kertoo muuta, oletetaan että ikkuna näkyy
+VisibilityTracker::VisibilityTracker(QObject *parent) :
+    QObject(parent), applicationActive(true), coverActive(false),
+    hiddenCpuStart(0), hiddenMSecs(0), hiddenCpuMSecs(0)
+{
+}
+
+void VisibilityTracker::setApplicationActive(bool active) {
+    if (active == applicationActive)
+        return;
+    bool wasVisible = isVisible();
+    applicationActive = active;
+    emit applicationActiveChanged();
+    update(wasVisible);
+}
+
+void VisibilityTracker::setCoverActive(bool active) {
+    if (active == coverActive)
+        return;
+    bool wasVisible = isVisible();
+    coverActive = active;
+    emit coverActiveChanged();
+    update(wasVisible);
+}
+
+qint64 VisibilityTracker::getHiddenMSecs() const {
+    return hiddenMSecs + (isVisible() ? 0 : hiddenClock.elapsed());
+}
+
+qint64 VisibilityTracker::getHiddenCpuMSecs() const {
+    return hiddenCpuMSecs + (isVisible() ? 0 : cpuMSecs() - hiddenCpuStart);
+}
+
+void VisibilityTracker::update(bool wasVisible) {
+    bool visible = isVisible();
+    if (visible == wasVisible)
+        return;
+
+    if (!visible) {
+        hiddenClock.start();
+        hiddenCpuStart = cpuMSecs();
+    } else {
+        qint64 hidden = hiddenClock.elapsed();
+        qint64 cpu = cpuMSecs() - hiddenCpuStart;
+        hiddenMSecs += hidden;
+        hiddenCpuMSecs += cpu;
+        qDebug() << "visibility: hidden for" << hidden / 1000 << "s, cpu" << cpu << "ms,"
+                 << hiddenCpuMSecs << "ms in" << hiddenMSecs / 1000 << "s total";
+    }
+    emit visibleChanged(visible);
+}
+
+// koko prosessin kaikki säikeet. clock() on ARMilla 32-bittinen ja
+// pyörähtää ympäri jo noin 36 minuutissa, tämä ei.
+qint64 VisibilityTracker::cpuMSecs() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,61 @@
+#ifndef VISIBILITYTRACKER_H
+#define VISIBILITYTRACKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+// Whether anything of the app is on screen: the application window is
+// active or the cover is showing. QML feeds both flags in with Binding
+// elements (Qt.application.active and the cover status). Models connect
+// visibleChanged() to their setActive() slot, drop their wakeups while
+// hidden and refresh once when shown again.
+//
+// Keeps count of how long the app has been hidden and how much process
+// CPU time went by meanwhile, and logs both on every reactivation.
+class VisibilityTracker : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool applicationActive READ isApplicationActive WRITE setApplicationActive NOTIFY applicationActiveChanged)
+    Q_PROPERTY(bool coverActive READ isCoverActive WRITE setCoverActive NOTIFY coverActiveChanged)
+    Q_PROPERTY(bool visible READ isVisible NOTIFY visibleChanged)
+
+public:
+    explicit VisibilityTracker(QObject *parent = 0);
+
+    inline bool isApplicationActive() const {
+        return applicationActive;
+    }
+    void setApplicationActive(bool active);
+
+    inline bool isCoverActive() const {
+        return coverActive;
+    }
+    void setCoverActive(bool active);
+
+    inline bool isVisible() const {
+        return applicationActive || coverActive;
+    }
+
+    // piilossa vietetty aika ja sen aikana kulunut prosessorin aika
+    qint64 getHiddenMSecs() const;
+    qint64 getHiddenCpuMSecs() const;
+
+signals:
+    void applicationActiveChanged();
+    void coverActiveChanged();
+    void visibleChanged(bool visible);
+
+private:
+    void update(bool wasVisible);
+    static qint64 cpuMSecs();
+
+    bool applicationActive;
+    bool coverActive;
+    QElapsedTimer hiddenClock;
+    qint64 hiddenCpuStart;
+    qint64 hiddenMSecs;
+    qint64 hiddenCpuMSecs;
+};
+
+#endif // VISIBILITYTRACKER_H
@@ -0,0 +1,225 @@
+#include "wakeupscheduler.h"
+#include <QCoreApplication>
+
+// pitkätkin odotukset katkaistaan, niin kellon siirrot huomataan
+static const qint64 MaxInterval = 60 * 60 * 1000;
+static const int StatsDays = 7;
+
+static qint64 wallClock() {
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+WakeupScheduler::WakeupScheduler(QObject *parent) :
+    QObject(parent), clock(wallClock), armedAt(-1), activeClients(0), tolerance(5000), wakeups(0)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(wakeup()));
+}
+
+WakeupScheduler *WakeupScheduler::instance() {
+    static WakeupScheduler *scheduler = 0;
+    if (!scheduler)
+        scheduler = new WakeupScheduler(QCoreApplication::instance());
+    return scheduler;
+}
+
+void WakeupScheduler::schedule(QObject *receiver, const char *member, const QDateTime &deadline) {
+    ClientKey key(receiver, QByteArray(member));
+    int id = clientIds.value(key, -1);
+    if (id < 0) {
+        if (!freeClients.isEmpty()) {
+            id = freeClients.takeLast();
+        } else {
+            id = clients.count();
+            clients.append(Client());
+        }
+        clientIds.insert(key, id);
+        connect(receiver, SIGNAL(destroyed(QObject*)), this, SLOT(receiverDestroyed(QObject*)), Qt::UniqueConnection);
+    }
+
+    Client &client = clients[id];
+    if (!client.active)
+        ++activeClients;
+    client.receiver = receiver;
+    client.member = key.second;
+    client.deadline = deadline.toMSecsSinceEpoch();
+    client.active = true;
+    ++client.generation;
+
+    Entry entry;
+    entry.deadline = client.deadline;
+    entry.client = id;
+    entry.generation = client.generation;
+    push(entry);
+
+    // vanhentuneita ei päästetä kasautumaan loputtomiin
+    if (heap.count() > 4 * activeClients + 16) {
+        QVector<Entry> live;
+        foreach (const Entry &e, heap) {
+            if (!isStale(e))
+                live.append(e);
+        }
+        heap.clear();
+        foreach (const Entry &e, live)
+            push(e);
+    }
+    arm();
+}
+
+void WakeupScheduler::cancel(QObject *receiver, const char *member) {
+    QHash<ClientKey, int>::iterator it = clientIds.find(ClientKey(receiver, QByteArray(member)));
+    if (it == clientIds.end())
+        return;
+    Client &client = clients[it.value()];
+    if (client.active)
+        --activeClients;
+    client.active = false;
+    freeClients.append(it.value());
+    clientIds.erase(it);
+    arm();
+}
+
+void WakeupScheduler::setClock(Clock value) {
+    clock = value ? value : wallClock;
+    arm();
+}
+
+WakeupScheduler::DayStats WakeupScheduler::getDayStats(const QDate &day) const {
+    foreach (const DayStats &dayStats, stats) {
+        if (dayStats.day == day)
+            return dayStats;
+    }
+    DayStats empty;
+    empty.day = day;
+    return empty;
+}
+
+void WakeupScheduler::setTolerance(int msecs) {
+    if (msecs == tolerance)
+        return;
+    tolerance = qMax(0, msecs);
+    arm();
+}
+
+void WakeupScheduler::wakeup() {
+    qint64 now = clock();
+
+    // kerätään ensin, vastaanottaja voi ajastaa itsensä uudelleen kutsussa
+    QVector<int> due;
+    dropStale();
+    while (!heap.isEmpty() && heap.first().deadline <= now) {
+        Entry entry = pop();
+        Client &client = clients[entry.client];
+        client.active = false;
+        --activeClients;
+        due.append(entry.client);
+        dropStale();
+    }
+
+    foreach (int id, due) {
+        const Client &client = clients.at(id);
+        ClientKey key(client.receiver, client.member);
+        // aiempi kutsu on voinut ajastaa uudelleen tai tuhota vastaanottajan
+        if (client.active || clientIds.value(key, -1) != id)
+            continue;
+        clientIds.remove(key);
+        freeClients.append(id);
+        QMetaObject::invokeMethod(key.first, key.second.constData());
+    }
+
+    if (!due.isEmpty())
+        countWakeup(due.count());
+    arm();
+}
+
+void WakeupScheduler::receiverDestroyed(QObject *receiver) {
+    QHash<ClientKey, int>::iterator it = clientIds.begin();
+    while (it != clientIds.end()) {
+        if (it.key().first == receiver) {
+            Client &client = clients[it.value()];
+            if (client.active)
+                --activeClients;
+            client.active = false;
+            freeClients.append(it.value());
+            it = clientIds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    arm();
+}
+
+void WakeupScheduler::push(const Entry &entry) {
+    heap.append(entry);
+    int i = heap.count() - 1;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap.at(parent).deadline <= heap.at(i).deadline)
+            break;
+        qSwap(heap[parent], heap[i]);
+        i = parent;
+    }
+}
+
+WakeupScheduler::Entry WakeupScheduler::pop() {
+    Entry top = heap.first();
+    heap[0] = heap.last();
+    heap.removeLast();
+    int i = 0;
+    int count = heap.count();
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < count && heap.at(left).deadline < heap.at(smallest).deadline)
+            smallest = left;
+        if (right < count && heap.at(right).deadline < heap.at(smallest).deadline)
+            smallest = right;
+        if (smallest == i)
+            break;
+        qSwap(heap[i], heap[smallest]);
+        i = smallest;
+    }
+    return top;
+}
+
+void WakeupScheduler::dropStale() {
+    while (!heap.isEmpty() && isStale(heap.first()))
+        pop();
+}
+
+void WakeupScheduler::arm() {
+    dropStale();
+    if (heap.isEmpty()) {
+        timer.stop();
+        armedAt = -1;
+        return;
+    }
+
+    // herätään vasta kun ikkunan viimeinenkin määräaika on ohi
+    qint64 window = heap.first().deadline + tolerance;
+    qint64 target = heap.first().deadline;
+    foreach (const Entry &entry, heap) {
+        if (entry.deadline <= window && entry.deadline > target && !isStale(entry))
+            target = entry.deadline;
+    }
+
+    qint64 now = clock();
+    qint64 delay = qBound<qint64>(0, target - now, MaxInterval);
+    armedAt = now + delay;
+    timer.start(int(delay));
+}
+
+void WakeupScheduler::countWakeup(int fired) {
+    ++wakeups;
+    QDate today = QDateTime::fromMSecsSinceEpoch(clock()).date();
+    if (stats.isEmpty() || stats.last().day != today) {
+        if (stats.count() == StatsDays)
+            stats.remove(0);
+        stats.append(DayStats());
+        stats.last().day = today;
+    }
+    ++stats.last().wakeups;
+    stats.last().deadlines += fired;
+}
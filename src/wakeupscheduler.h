@@ -0,0 +1,122 @@
+#ifndef WAKEUPSCHEDULER_H
+#define WAKEUPSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDate>
+#include <QDateTime>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QByteArray>
+
+// One timer for every wall-clock deadline in the app: TJ day changes,
+// meal changes and the leaderboard's midnight. Deadlines sit in a binary
+// min-heap and the timer is armed only for the earliest one. Deadlines
+// that fall within the tolerance window of the earliest are fired in the
+// same wakeup; the timer is then armed for the latest of them, so a
+// deadline may fire up to tolerance late but never early.
+//
+// Lives in the GUI thread. Receivers are called by slot name, a new
+// schedule() for the same receiver and slot replaces the old deadline.
+//
+// Wakeups and fired deadlines are counted per day of the scheduler's
+// clock for the last week. The clock can be replaced, so a test can run
+// through simulated days without waiting for them.
+class WakeupScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    typedef qint64 (*Clock)();
+
+    struct DayStats {
+        DayStats() : wakeups(0), deadlines(0) {}
+        QDate day;
+        int wakeups;
+        int deadlines;
+    };
+
+    explicit WakeupScheduler(QObject *parent = 0);
+
+    static WakeupScheduler *instance();
+
+    void schedule(QObject *receiver, const char *member, const QDateTime &deadline);
+    void cancel(QObject *receiver, const char *member);
+
+    inline int getTolerance() const {
+        return tolerance;
+    }
+    void setTolerance(int msecs);
+
+    // millisekunteja epochista, oletuksena seinäkello
+    void setClock(Clock clock);
+    inline QDateTime currentDateTime() const {
+        return QDateTime::fromMSecsSinceEpoch(clock());
+    }
+
+    inline int getWakeups() const {
+        return wakeups;
+    }
+
+    // tyhjä jos päivä on yli viikon takana
+    DayStats getDayStats(const QDate &day) const;
+
+    // ajastimen kohde kellon aikana, -1 jos mitään ei odoteta
+    inline qint64 getNextWakeup() const {
+        return timer.isActive() ? armedAt : -1;
+    }
+
+    // odottavat määräajat, piilossa tämän pitää olla nolla
+    inline int getPending() const {
+        return activeClients;
+    }
+
+private slots:
+    void wakeup();
+    void receiverDestroyed(QObject *receiver);
+
+private:
+    typedef QPair<QObject *, QByteArray> ClientKey;
+
+    struct Client {
+        Client() : receiver(0), deadline(0), generation(0), active(false) {}
+        QObject *receiver;
+        QByteArray member;
+        qint64 deadline;
+        quint32 generation;
+        bool active;
+    };
+
+    // vanhentuneet alkiot jäävät kekoon ja ohitetaan kun ne nousevat pinnalle
+    struct Entry {
+        qint64 deadline;
+        int client;
+        quint32 generation;
+    };
+
+    inline bool isStale(const Entry &entry) const {
+        const Client &client = clients.at(entry.client);
+        return !client.active || client.generation != entry.generation;
+    }
+
+    void push(const Entry &entry);
+    Entry pop();
+    void dropStale();
+    void arm();
+    void countWakeup(int fired);
+
+    Clock clock;
+    QTimer timer;
+    qint64 armedAt;
+    QVector<Entry> heap;
+    QVector<Client> clients;
+    QVector<int> freeClients;
+    QHash<ClientKey, int> clientIds;
+    int activeClients;
+    int tolerance;
+
+    int wakeups;
+    QVector<DayStats> stats;
+};
+
+#endif // WAKEUPSCHEDULER_H
@@ -0,0 +1,12 @@
+TARGET = tst_appstate
+TEMPLATE = app
+
+include(../tests.pri)
+
+# oma main() valitsee offscreen-alustan, jos muuta ei ole annettu
+QT += gui qml
+
+SOURCES += tst_appstate.cpp \
+    $$SRC/visibilitytracker.cpp
+
+HEADERS += $$SRC/visibilitytracker.h
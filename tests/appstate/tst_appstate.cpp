@@ -0,0 +1,133 @@
+#include <QtTest>
+#include <QGuiApplication>
+#include <QWindow>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include "visibilitytracker.h"
+
+static VisibilityTracker *visibilityInstance = 0;
+
+static QObject *visibilitySingleton(QQmlEngine *engine, QJSEngine *) {
+    engine->setObjectOwnership(visibilityInstance, QQmlEngine::CppOwnership);
+    return visibilityInstance;
+}
+
+// The Bindings of SotkuMuija.qml and CoverPage.qml against a real
+// QGuiApplication on the offscreen platform. Showing and activating a
+// window makes the application active and hiding it makes it inactive,
+// and the tracker has to follow through Qt.application.active. The cover
+// status is stood in for by a property of the root item, as Sailfish
+// Silica is not available here.
+class TestAppState : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void followsApplicationState();
+    void coverKeepsVisible();
+
+private:
+    void setApplicationActive(bool active);
+
+    QQmlEngine *engine;
+    QObject *root;
+    QWindow *window;
+};
+
+void TestAppState::initTestCase() {
+    visibilityInstance = new VisibilityTracker;
+    qmlRegisterSingletonType<VisibilityTracker>("SotkuMuija", 1, 0, "Visibility", visibilitySingleton);
+
+    engine = new QQmlEngine;
+    QQmlComponent component(engine);
+    component.setData("import QtQuick 2.0\n"
+                      "import SotkuMuija 1.0\n"
+                      "Item {\n"
+                      "    property bool coverShown: false\n"
+                      "    Binding {\n"
+                      "        target: Visibility\n"
+                      "        property: \"applicationActive\"\n"
+                      "        value: Qt.application.active\n"
+                      "    }\n"
+                      "    Binding {\n"
+                      "        target: Visibility\n"
+                      "        property: \"coverActive\"\n"
+                      "        value: coverShown\n"
+                      "    }\n"
+                      "}\n", QUrl());
+    root = component.create();
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    window = new QWindow;
+    window->resize(100, 100);
+}
+
+void TestAppState::cleanupTestCase() {
+    delete window;
+    delete root;
+    delete engine;
+    delete visibilityInstance;
+}
+
+// ikkunan aktivointi on ainoa tapa muuttaa sovelluksen tilaa ilman alustaa
+void TestAppState::setApplicationActive(bool active) {
+    if (active) {
+        window->show();
+        window->requestActivate();
+        QTRY_COMPARE(QGuiApplication::applicationState(), Qt::ApplicationActive);
+    } else {
+        window->hide();
+        QTRY_VERIFY(QGuiApplication::applicationState() != Qt::ApplicationActive);
+    }
+}
+
+void TestAppState::followsApplicationState() {
+    QSignalSpy visible(visibilityInstance, SIGNAL(visibleChanged(bool)));
+
+    setApplicationActive(true);
+    QTRY_VERIFY(visibilityInstance->isApplicationActive());
+    QVERIFY(visibilityInstance->isVisible());
+
+    visible.clear();
+    setApplicationActive(false);
+    QTRY_VERIFY(!visibilityInstance->isApplicationActive());
+    QVERIFY(!visibilityInstance->isVisible());
+    QCOMPARE(visible.count(), 1);
+    QCOMPARE(visible.first().first().toBool(), false);
+
+    setApplicationActive(true);
+    QTRY_VERIFY(visibilityInstance->isVisible());
+    QCOMPARE(visible.count(), 2);
+    QCOMPARE(visible.last().first().toBool(), true);
+}
+
+// kansi näkyy, vaikka sovellus ei ole aktiivinen
+void TestAppState::coverKeepsVisible() {
+    setApplicationActive(true);
+    QTRY_VERIFY(visibilityInstance->isApplicationActive());
+    root->setProperty("coverShown", true);
+    QVERIFY(visibilityInstance->isCoverActive());
+
+    QSignalSpy visible(visibilityInstance, SIGNAL(visibleChanged(bool)));
+    setApplicationActive(false);
+    QTRY_VERIFY(!visibilityInstance->isApplicationActive());
+    QVERIFY(visibilityInstance->isVisible());
+    QCOMPARE(visible.count(), 0);
+
+    root->setProperty("coverShown", false);
+    QVERIFY(!visibilityInstance->isVisible());
+    QCOMPARE(visible.count(), 1);
+}
+
+int main(int argc, char *argv[]) {
+    // sama kuin -platform offscreen: ei tarvita näyttöä
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    TestAppState test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_appstate.moc"
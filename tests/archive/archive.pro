@@ -0,0 +1,10 @@
+TARGET = tst_archive
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += tst_archive.cpp \
+    $$SRC/menuarchive.cpp
+
+HEADERS += $$SRC/menuarchive.h \
+    $$SRC/menuday.h
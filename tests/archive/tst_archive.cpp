@@ -0,0 +1,198 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "menuarchive.h"
+
+// The append-only menu archive in a temporary directory: appends and
+// reopening, storing only changed days, recovery from a torn tail, range
+// queries and a generated multi-year archive.
+class TestArchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void appendAndReopen();
+    void storesOnlyChanges();
+    void tornTail();
+    void range();
+    void multiYear();
+
+private:
+    static QVector<MenuDay> week(const QDate &monday, const QByteArray &tag);
+
+    QTemporaryDir *dir;
+    QString fileName;
+};
+
+void TestArchive::init() {
+    dir = new QTemporaryDir;
+    fileName = dir->path() + "/menus.archive";
+}
+
+void TestArchive::cleanup() {
+    delete dir;
+}
+
+// viikon ruokalista kuten syötteessä, tag erottaa versiot toisistaan
+QVector<MenuDay> TestArchive::week(const QDate &monday, const QByteArray &tag) {
+    static const char *const dishes[] = {
+        "Kaurapuuro", "Hernekeitto", "Makaronilaatikko", "Lihakeitto", "Kalakeitto",
+        "Jauhelihakastike ja perunat", "Broileripasta", "Lihapullat ja muusi", "Pinaattiletut"
+    };
+    const int dishCount = sizeof(dishes) / sizeof(dishes[0]);
+    QVector<MenuDay> days;
+    for (int i = 0; i < 7; ++i) {
+        MenuDay day;
+        day.date = monday.addDays(i);
+        day.name = QDate::longDayName(i + 1);
+        qint64 julianDay = day.date.toJulianDay();
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            day.meals[slot] = QString::fromUtf8(dishes[(julianDay + slot * 2) % dishCount]) + ' ' + tag;
+        days.append(day);
+    }
+    return days;
+}
+
+void TestArchive::appendAndReopen() {
+    QDate monday(2026, 3, 2);
+    {
+        MenuArchive archive;
+        QVERIFY(archive.open(fileName));
+        QVERIFY(archive.isOpen());
+        QCOMPARE(archive.blockCount(), 0);
+        QVERIFY(!archive.firstDate().isValid());
+        QCOMPARE(archive.append(week(monday, "a")), 7);
+        QCOMPARE(archive.append(week(monday.addDays(7), "a")), 7);
+    }
+
+    MenuArchive archive;
+    QVERIFY(archive.open(fileName));
+    QCOMPARE(archive.blockCount(), 2);
+    QCOMPARE(archive.firstDate(), monday);
+    QCOMPARE(archive.lastDate(), monday.addDays(13));
+    QCOMPARE(archive.blockFirstDate(1), monday.addDays(7));
+
+    QVector<MenuDay> days = archive.range();
+    QCOMPARE(days.count(), 14);
+    QVector<MenuDay> expected = week(monday, "a") + week(monday.addDays(7), "a");
+    for (int i = 0; i < days.count(); ++i) {
+        QCOMPARE(days.at(i).date, expected.at(i).date);
+        QCOMPARE(days.at(i).name, expected.at(i).name);
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            QCOMPARE(days.at(i).meals[slot], expected.at(i).meals[slot]);
+    }
+}
+
+// sama lista joka päivityksellä ei kasvata arkistoa, korjattu päivä kyllä
+void TestArchive::storesOnlyChanges() {
+    QDate monday(2026, 3, 2);
+    MenuArchive archive;
+    QVERIFY(archive.open(fileName));
+    QCOMPARE(archive.append(week(monday, "a")), 7);
+    qint64 size = QFileInfo(fileName).size();
+
+    QCOMPARE(archive.append(week(monday, "a")), 0);
+    QCOMPARE(archive.blockCount(), 1);
+    QCOMPARE(QFileInfo(fileName).size(), size);
+
+    QVector<MenuDay> corrected = week(monday, "a");
+    corrected[2].meals[Lunch] = "Hernekeitto ja pannukakku";
+    QCOMPARE(archive.append(corrected), 1);
+    QCOMPARE(archive.blockCount(), 2);
+    QCOMPARE(archive.blockFirstDate(1), monday.addDays(2));
+    QCOMPARE(archive.blockLastDate(1), monday.addDays(2));
+
+    // uusin lohko voittaa
+    QVector<MenuDay> days = archive.range(monday.addDays(2), monday.addDays(2));
+    QCOMPARE(days.count(), 1);
+    QCOMPARE(days.first().meals[Lunch], QString("Hernekeitto ja pannukakku"));
+    QCOMPARE(archive.range().count(), 7);
+}
+
+// kaatuminen kesken kirjoituksen: vajaa lohko ohitetaan ja kirjoitetaan yli
+void TestArchive::tornTail() {
+    QDate monday(2026, 3, 2);
+    qint64 firstBlockEnd;
+    {
+        MenuArchive archive;
+        QVERIFY(archive.open(fileName));
+        archive.append(week(monday, "a"));
+        firstBlockEnd = QFileInfo(fileName).size();
+        archive.append(week(monday.addDays(7), "a"));
+    }
+    QFile file(fileName);
+    QVERIFY(file.resize(QFileInfo(fileName).size() - 5));
+
+    MenuArchive archive;
+    QVERIFY(archive.open(fileName));
+    QCOMPARE(archive.blockCount(), 1);
+    QCOMPARE(archive.lastDate(), monday.addDays(6));
+    QCOMPARE(archive.range().count(), 7);
+
+    QCOMPARE(archive.append(week(monday.addDays(7), "b")), 7);
+    QCOMPARE(archive.blockCount(), 2);
+
+    MenuArchive reopened;
+    QVERIFY(reopened.open(fileName));
+    QCOMPARE(reopened.blockCount(), 2);
+    QVERIFY(QFileInfo(fileName).size() > firstBlockEnd);
+    QVector<MenuDay> days = reopened.range(monday.addDays(7));
+    QCOMPARE(days.count(), 7);
+    QVERIFY(days.first().meals[Breakfast].endsWith(" b"));
+}
+
+void TestArchive::range() {
+    MenuArchive archive;
+    QVERIFY(archive.open(fileName));
+    for (QDate monday(2026, 2, 2); monday < QDate(2026, 5, 1); monday = monday.addDays(7))
+        archive.append(week(monday, "a"));
+
+    QVector<MenuDay> march = archive.range(QDate(2026, 3, 1), QDate(2026, 3, 31));
+    QCOMPARE(march.count(), 31);
+    QCOMPARE(march.first().date, QDate(2026, 3, 1));
+    QCOMPARE(march.last().date, QDate(2026, 3, 31));
+    for (int i = 1; i < march.count(); ++i)
+        QCOMPARE(march.at(i).date, march.at(i - 1).date.addDays(1));
+
+    QCOMPARE(archive.range(QDate(2026, 4, 20)).count(), 14);
+    QCOMPARE(archive.range(QDate(), QDate(2026, 2, 4)).count(), 3);
+    QVERIFY(archive.range(QDate(2027, 1, 1)).isEmpty());
+    QVERIFY(archive.range(QDate(2026, 3, 10), QDate(2026, 3, 9)).isEmpty());
+}
+
+// viisi vuotta viikko kerrallaan: pieni tiedosto, kuukauden haku nopea
+void TestArchive::multiYear() {
+    MenuArchive archive;
+    QVERIFY(archive.open(fileName));
+    int days = 0;
+    for (QDate monday(2021, 1, 4); monday < QDate(2026, 1, 1); monday = monday.addDays(7))
+        days += archive.append(week(monday, "a"));
+    QCOMPARE(archive.blockCount(), days / 7);
+
+    qint64 size = QFileInfo(fileName).size();
+    QVERIFY2(size / days < 150, qPrintable(QString("%1 bytes per day").arg(size / days)));
+
+    QElapsedTimer timer;
+    timer.start();
+    MenuArchive reopened;
+    QVERIFY(reopened.open(fileName));
+    QVector<MenuDay> march = reopened.range(QDate(2024, 3, 1), QDate(2024, 3, 31));
+    qint64 msecs = timer.elapsed();
+    QCOMPARE(reopened.blockCount(), archive.blockCount());
+    QCOMPARE(march.count(), 31);
+    QCOMPARE(march.first().date, QDate(2024, 3, 1));
+    QVERIFY2(msecs < 20, qPrintable(QString("%1 ms").arg(msecs)));
+
+    // kuukausi koskee enintään kuutta viikkolohkoa
+    int overlapping = 0;
+    for (int i = 0; i < reopened.blockCount(); ++i) {
+        if (reopened.blockLastDate(i) >= QDate(2024, 3, 1) && reopened.blockFirstDate(i) <= QDate(2024, 3, 31))
+            ++overlapping;
+    }
+    QCOMPARE(overlapping, 5);
+}
+
+QTEST_GUILESS_MAIN(TestArchive)
+
+#include "tst_archive.moc"
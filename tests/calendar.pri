@@ -0,0 +1,27 @@
+# QFoodCalendar and what it needs. WakeupScheduler comes from tj.pri.
+QT += network
+
+SOURCES += $$SRC/qfoodcalendar.cpp \
+    $$SRC/menuparser.cpp \
+    $$SRC/menuparseworker.cpp \
+    $$SRC/menucache.cpp \
+    $$SRC/menusnapshot.cpp \
+    $$SRC/menuarchive.cpp \
+    $$SRC/dishpool.cpp \
+    $$SRC/dishindex.cpp \
+    $$SRC/mealschedule.cpp \
+    $$SRC/mealindex.cpp \
+    $$SRC/mealconfig.cpp
+
+HEADERS += $$SRC/qfoodcalendar.h \
+    $$SRC/menuday.h \
+    $$SRC/menuparser.h \
+    $$SRC/menuparseworker.h \
+    $$SRC/menucache.h \
+    $$SRC/menusnapshot.h \
+    $$SRC/menuarchive.h \
+    $$SRC/dishpool.h \
+    $$SRC/dishindex.h \
+    $$SRC/mealschedule.h \
+    $$SRC/mealindex.h \
+    $$SRC/mealconfig.h
@@ -0,0 +1,10 @@
+TARGET = tst_dishindex
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += tst_dishindex.cpp \
+    $$SRC/dishindex.cpp
+
+HEADERS += $$SRC/dishindex.h \
+    $$SRC/menuday.h
@@ -0,0 +1,181 @@
+#include <QtTest>
+#include "dishindex.h"
+
+// Word and prefix search, date filtering and incremental updates of the
+// dish index, and the query time over a year of generated menus.
+class TestDishIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void normalize();
+    void prefixSearch();
+    void foldedSpelling();
+    void allWordsMustMatch();
+    void dateFilter();
+    void incrementalUpdate();
+    void oneLetterQuery();
+    void yearQueryTime();
+
+private:
+    static void addDay(DishIndex &index, const QDate &date, const QString &breakfast,
+                       const QString &lunch, const QString &dinner = QString(), const QString &supper = QString());
+    static QStringList texts(const DishIndex &index, const QVector<DishIndex::Posting> &postings);
+};
+
+static const QDate Monday(2026, 3, 2);
+
+void TestDishIndex::addDay(DishIndex &index, const QDate &date, const QString &breakfast,
+                           const QString &lunch, const QString &dinner, const QString &supper) {
+    QString meals[MealSlotCount] = { breakfast, lunch, dinner, supper };
+    index.addDay(date, meals);
+}
+
+QStringList TestDishIndex::texts(const DishIndex &index, const QVector<DishIndex::Posting> &postings) {
+    QStringList result;
+    foreach (const DishIndex::Posting &posting, postings)
+        result << index.text(posting);
+    return result;
+}
+
+void TestDishIndex::normalize() {
+    QCOMPARE(DishIndex::normalize(QString::fromUtf8("Jäätelö")), QString::fromUtf8("jäätelö"));
+    QCOMPARE(DishIndex::normalize(QString::fromUtf8("Crème brûlée")), QString("creme brulee"));
+    QCOMPARE(DishIndex::fold(QString::fromUtf8("jäätelö")), QString("jaatelo"));
+    QCOMPARE(DishIndex::tokenize(QString::fromUtf8("Puuroa, leipää & 2 x ML")),
+             QStringList() << "puuroa" << QString::fromUtf8("leipää") << "ml");
+}
+
+void TestDishIndex::prefixSearch() {
+    DishIndex index;
+    addDay(index, Monday, "Kaurapuuro", "Hernekeitto, pannukakku");
+    addDay(index, Monday.addDays(1), "Mannapuuro", "Makaronilaatikko");
+    addDay(index, Monday.addDays(2), "Kaurapuuro", "Hernerokka");
+
+    QCOMPARE(index.search("herne").count(), 2);
+    QCOMPARE(index.search("HERNEKEITTO").count(), 1);
+    QCOMPARE(texts(index, index.search("kaura")), QStringList() << "Kaurapuuro" << "Kaurapuuro");
+    // sanan keskeltä ei löydy
+    QVERIFY(index.search("puuro").isEmpty());
+    QVERIFY(index.search("kala").isEmpty());
+
+    // päivän ja aterian mukaan järjestyksessä
+    QVector<DishIndex::Posting> found = index.search("ma");
+    QCOMPARE(found.count(), 2);
+    QCOMPARE(found.at(0).julianDay, Monday.addDays(1).toJulianDay());
+    QCOMPARE(found.at(0).slot, int(Breakfast));
+    QCOMPARE(found.at(1).slot, int(Lunch));
+}
+
+// ilman ä:tä ja ö:tä kirjoitettu haku löytää silti, ä:llä kirjoitettu vain ä:n
+void TestDishIndex::foldedSpelling() {
+    DishIndex index;
+    addDay(index, Monday, QString::fromUtf8("Jäätelö"), "Jaakkolan makkara");
+
+    QCOMPARE(index.search("jaatelo").count(), 1);
+    QCOMPARE(index.search("jaa").count(), 2);
+    QCOMPARE(texts(index, index.search(QString::fromUtf8("jää"))), QStringList() << QString::fromUtf8("Jäätelö"));
+}
+
+void TestDishIndex::allWordsMustMatch() {
+    DishIndex index;
+    addDay(index, Monday, "Kalakeitto", "Uunikala ja perunat");
+    addDay(index, Monday.addDays(1), "Perunamuusi", "Broileria ja perunat");
+
+    QCOMPARE(texts(index, index.search("peru uuni")), QStringList() << "Uunikala ja perunat");
+    QCOMPARE(index.search("peru").count(), 3);
+    QVERIFY(index.search("peru kala").isEmpty());
+}
+
+void TestDishIndex::dateFilter() {
+    DishIndex index;
+    for (int day = 0; day < 60; ++day)
+        addDay(index, Monday.addDays(day), "Puuro", day % 7 == 3 ? "Hernekeitto" : "Kala");
+
+    QCOMPARE(index.search("hernekeitto").count(), 9);
+    QVector<DishIndex::Posting> march = index.search("hernekeitto", QDate(2026, 3, 1), QDate(2026, 3, 31));
+    QCOMPARE(march.count(), 5);
+    QCOMPARE(march.first().julianDay, QDate(2026, 3, 5).toJulianDay());
+    QCOMPARE(march.last().julianDay, QDate(2026, 3, 26).toJulianDay());
+    // rajapäivät mukaan lukien
+    QCOMPARE(index.search("hernekeitto", QDate(2026, 3, 5), QDate(2026, 3, 5)).count(), 1);
+    QCOMPARE(index.search("hernekeitto", QDate(2026, 4, 1)).count(), 4);
+    QCOMPARE(index.search("hernekeitto", QDate(), QDate(2026, 3, 12)).count(), 2);
+}
+
+// uusi viikko lisätään, muuttunut päivä korvaa vanhan
+void TestDishIndex::incrementalUpdate() {
+    DishIndex index;
+    addDay(index, Monday, "Puuro", "Hernekeitto");
+    QCOMPARE(index.dayCount(), 1);
+
+    QString same[MealSlotCount] = { "Puuro", "Hernekeitto", QString(), QString() };
+    QVERIFY(!index.addDay(Monday, same));
+
+    QString changed[MealSlotCount] = { "Puuro", "Makaronilaatikko", QString(), QString() };
+    QVERIFY(index.addDay(Monday, changed));
+    QVERIFY(index.search("hernekeitto").isEmpty());
+    QCOMPARE(index.search("makaroni").count(), 1);
+    QCOMPARE(index.search("puuro").count(), 1);
+
+    addDay(index, Monday.addDays(7), "Puuro", "Hernekeitto");
+    QCOMPARE(index.dayCount(), 2);
+    QCOMPARE(index.search("puuro").count(), 2);
+    QCOMPARE(index.search("hernekeitto").first().julianDay, Monday.addDays(7).toJulianDay());
+}
+
+// yksikirjaiminen haku, vaikka yksikirjaimisia sanoja ei indeksoida
+void TestDishIndex::oneLetterQuery() {
+    DishIndex index;
+    addDay(index, Monday, "Puuro ja leipä", "Hernekeitto");
+    addDay(index, Monday.addDays(1), "Jogurtti", "Kala");
+
+    QCOMPARE(index.search("h").count(), 1);
+    QCOMPARE(index.search("j").count(), 2);
+    QCOMPARE(index.search("k").count(), 1);
+    QVERIFY(index.search("x").isEmpty());
+}
+
+// vuoden ruokalistat: haun on vastattava selvästi alle millisekunnissa
+void TestDishIndex::yearQueryTime() {
+    static const char *const dishes[] = {
+        "Kaurapuuro", "Mannapuuro", "Ruispuuro", "Hernekeitto", "Makaronilaatikko",
+        "Lihakeitto", "Kalakeitto", "Jauhelihakastike ja perunat", "Broileripasta",
+        "Kalapuikot ja perunamuusi", "Lihapullat ja muusi", "Kasvislasagne",
+        "Pinaattiletut", "Uunimakkara", "Kirjolohi", "Jäätelö", "Pannukakku",
+        "Riisipuuro", "Tortillat", "Nakkikastike"
+    };
+    const int dishCount = sizeof(dishes) / sizeof(dishes[0]);
+    const QDate first(2025, 1, 1);
+
+    DishIndex index;
+    for (int day = 0; day < 365; ++day) {
+        QString meals[MealSlotCount];
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            meals[slot] = QString::fromUtf8(dishes[(day * 7 + slot * 3) % dishCount]);
+        index.addDay(first.addDays(day), meals);
+    }
+    QCOMPARE(index.dayCount(), 365);
+
+    const QStringList queries = QStringList() << "h" << "herne" << "puuro" << "ka" << "kala peru"
+                                              << QString::fromUtf8("jää") << "jaatelo" << "lihakeitto";
+    const int rounds = 200;
+    int found = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int round = 0; round < rounds; ++round) {
+        foreach (const QString &query, queries) {
+            found += index.search(query).count();
+            found += index.search(query, QDate(2025, 3, 1), QDate(2025, 3, 31)).count();
+        }
+    }
+    qint64 nsecs = timer.nsecsElapsed();
+    QVERIFY(found > 0);
+
+    qint64 perQuery = nsecs / (rounds * queries.count() * 2);
+    QVERIFY2(perQuery < 1000000, qPrintable(QString("%1 us per query").arg(perQuery / 1000)));
+}
+
+QTEST_GUILESS_MAIN(TestDishIndex)
+
+#include "tst_dishindex.moc"
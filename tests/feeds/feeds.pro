@@ -0,0 +1,9 @@
+TARGET = tst_feeds
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+include(../calendar.pri)
+include(../feedserver.pri)
+
+SOURCES += tst_feeds.cpp
@@ -0,0 +1,153 @@
+#include <QtTest>
+#include <QDir>
+#include <QStandardPaths>
+#include "qfoodcalendar.h"
+#include "feedserver.h"
+
+// Several feeds on one stand-in with a latency per feed: requests stay
+// within QFoodCalendar's limit of three, a slow first feed still sorts
+// first, and a failing or superseded feed does not disturb the rest.
+class TestFeeds : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void boundedConcurrency();
+    void totalFollowsSlowest();
+    void slowFeedKeepsOrder();
+    void failedFeedKeepsOthers();
+    void allFeedsFailed();
+    void reloadDropsOldFeeds();
+
+private:
+    QStringList urls(const QList<QByteArray> &paths) const;
+
+    FeedServer server;
+    QDate monday;
+};
+
+void TestFeeds::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(server.listen());
+    QDate today = QDate::currentDate();
+    monday = today.addDays(1 - today.dayOfWeek());
+}
+
+// ei välimuistia, ei viiveitä
+void TestFeeds::init() {
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).removeRecursively();
+    for (int i = 0; i < 5; ++i) {
+        QByteArray path = "/f" + QByteArray::number(i);
+        server.setDocument(path, FeedServer::menu(monday, 3, path.mid(1)));
+        server.setLatency(path, 0);
+    }
+    server.resetCounters();
+}
+
+QStringList TestFeeds::urls(const QList<QByteArray> &paths) const {
+    QStringList result;
+    foreach (const QByteArray &path, paths)
+        result << server.url(path).toString();
+    return result;
+}
+
+void TestFeeds::boundedConcurrency() {
+    QList<QByteArray> paths;
+    for (int i = 0; i < 5; ++i) {
+        paths << "/f" + QByteArray::number(i);
+        server.setLatency(paths.last(), 300);
+    }
+
+    QFoodCalendar model;
+    QElapsedTimer timer;
+    timer.start();
+    model.setSources(urls(paths));
+    QTRY_COMPARE_WITH_TIMEOUT(int(model.getStatus()), int(QFoodCalendar::Ready), 10000);
+
+    QCOMPARE(server.getRequests(), 5);
+    QCOMPARE(server.getMaxOpen(), 3);
+    // kolme ja kaksi: kaksi kierrosta viivettä
+    QVERIFY(timer.elapsed() >= 600);
+    QCOMPARE(model.rowCount(), 15);
+}
+
+// rinnakkain haettuna kokonaisaika on hitaimman syötteen, ei summan
+void TestFeeds::totalFollowsSlowest() {
+    server.setLatency("/f0", 100);
+    server.setLatency("/f1", 200);
+    server.setLatency("/f2", 400);
+
+    QFoodCalendar model;
+    QSignalSpy status(&model, SIGNAL(statusChanged()));
+    QElapsedTimer timer;
+    timer.start();
+    model.setSources(urls(QList<QByteArray>() << "/f0" << "/f1" << "/f2"));
+    while (model.getStatus() != QFoodCalendar::Ready)
+        QVERIFY(status.wait(5000));
+    qint64 total = timer.elapsed();
+
+    QCOMPARE(model.rowCount(), 9);
+    QCOMPARE(server.getMaxOpen(), 3);
+    QVERIFY2(total >= 400, QByteArray::number(total).constData());
+    // summa olisi 700 ms
+    QVERIFY2(total < 550, QByteArray::number(total).constData());
+}
+
+void TestFeeds::slowFeedKeepsOrder() {
+    server.setLatency("/f0", 400);
+    QFoodCalendar model;
+    model.setSources(urls(QList<QByteArray>() << "/f0" << "/f1"));
+
+    // nopea syöte näkyy ensin yksinään
+    QTRY_COMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(0), QFoodCalendar::SourceRole).toString(), server.url("/f1").toString());
+
+    QTRY_COMPARE(int(model.getStatus()), int(QFoodCalendar::Ready));
+    QCOMPARE(model.rowCount(), 6);
+    // saman päivän rivit syötteiden järjestyksessä
+    for (int row = 0; row < 6; ++row) {
+        QModelIndex index = model.index(row);
+        QCOMPARE(model.data(index, QFoodCalendar::DateRole).toDate(), monday.addDays(row / 2));
+        QCOMPARE(model.data(index, QFoodCalendar::SourceRole).toString(),
+                 server.url(row % 2 == 0 ? "/f0" : "/f1").toString());
+    }
+}
+
+void TestFeeds::failedFeedKeepsOthers() {
+    QFoodCalendar model;
+    model.setSources(urls(QList<QByteArray>() << "/missing" << "/f1"));
+    QTRY_COMPARE(int(model.getStatus()), int(QFoodCalendar::Ready));
+    QCOMPARE(model.getErrorString(), QString());
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(0), QFoodCalendar::SourceRole).toString(), server.url("/f1").toString());
+}
+
+void TestFeeds::allFeedsFailed() {
+    QFoodCalendar model;
+    model.setSources(urls(QList<QByteArray>() << "/missing" << "/gone"));
+    QTRY_COMPARE(int(model.getStatus()), int(QFoodCalendar::Error));
+    QVERIFY(!model.getErrorString().isEmpty());
+    QCOMPARE(model.rowCount(), 0);
+}
+
+// vanhan latauksen myöhästyneet päivät hylätään
+void TestFeeds::reloadDropsOldFeeds() {
+    server.setLatency("/f0", 300);
+    QFoodCalendar model;
+    model.setSources(urls(QList<QByteArray>() << "/f0"));
+    model.setSources(urls(QList<QByteArray>() << "/f1"));
+
+    QTRY_COMPARE(int(model.getStatus()), int(QFoodCalendar::Ready));
+    QTRY_COMPARE(server.getOpen(), 0);
+    QTest::qWait(100);
+    QCOMPARE(model.rowCount(), 3);
+    for (int row = 0; row < 3; ++row)
+        QCOMPARE(model.data(model.index(row), QFoodCalendar::SourceRole).toString(), server.url("/f1").toString());
+}
+
+QTEST_GUILESS_MAIN(TestFeeds)
+
+#include "tst_feeds.moc"
@@ -0,0 +1,171 @@
+#include "feedserver.h"
+#include <QTcpSocket>
+#include <QCryptographicHash>
+
+FeedServer::FeedServer(QObject *parent) :
+    QObject(parent), chunkBytes(0), interval(0),
+    requests(0), notModified(0), bytesSent(0), open(0), maxOpen(0)
+{
+    clock.start();
+    timer.setInterval(1);
+    connect(&server, SIGNAL(newConnection()), this, SLOT(acceptConnections()));
+    connect(&timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+bool FeedServer::listen() {
+    return server.listen(QHostAddress::LocalHost, 0);
+}
+
+QUrl FeedServer::url(const QByteArray &path) const {
+    return QUrl(QString("http://127.0.0.1:%1%2").arg(server.serverPort()).arg(QString::fromLatin1(path)));
+}
+
+QByteArray FeedServer::menu(const QDate &monday, int days, const QByteArray &tag, int padding) {
+    static const char *const meals[] = { "breakfast", "lunch", "dinner", "supper" };
+    QByteArray xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<menu>\n<week start=\""
+            + monday.toString(Qt::ISODate).toLatin1() + "\">\n";
+    for (int day = 1; day <= days; ++day) {
+        xml += "<day name=\"" + QByteArray::number(day) + "\">";
+        for (int slot = 0; slot < 4; ++slot) {
+            xml += '<';
+            xml += meals[slot];
+            xml += '>' + tag + ' ' + meals[slot] + ' ' + QByteArray::number(day);
+            if (padding > 0)
+                xml += ' ' + QByteArray(padding, 'x');
+            xml += "</";
+            xml += meals[slot];
+            xml += '>';
+        }
+        xml += "</day>\n";
+    }
+    xml += "</week>\n</menu>\n";
+    return xml;
+}
+
+void FeedServer::setDocument(const QByteArray &path, const QByteArray &body) {
+    Document &document = documents[path];
+    document.body = body;
+    document.etag = '"' + QCryptographicHash::hash(body, QCryptographicHash::Md5).toHex().left(16) + '"';
+}
+
+void FeedServer::setLatency(const QByteArray &path, int msecs) {
+    documents[path].latency = msecs;
+}
+
+void FeedServer::setThrottle(int bytes, int msecs) {
+    chunkBytes = bytes;
+    interval = msecs;
+    timer.setInterval(qMax(1, msecs));
+}
+
+void FeedServer::resetCounters() {
+    requests = 0;
+    notModified = 0;
+    bytesSent = 0;
+    maxOpen = open;
+}
+
+void FeedServer::acceptConnections() {
+    while (QTcpSocket *socket = server.nextPendingConnection()) {
+        connections.insert(socket, Connection());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    }
+}
+
+void FeedServer::readRequest() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket || !connections.contains(socket))
+        return;
+    Connection &connection = connections[socket];
+    connection.buffer += socket->readAll();
+    if (connection.answering || !connection.buffer.contains("\r\n\r\n"))
+        return;
+    answer(socket, connection);
+}
+
+void FeedServer::clientDisconnected() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket)
+        return;
+    // asiakas luovutti kesken vastauksen
+    if (connections.value(socket).answering)
+        --open;
+    connections.remove(socket);
+    socket->deleteLater();
+}
+
+void FeedServer::answer(QTcpSocket *socket, Connection &connection) {
+    QList<QByteArray> lines = connection.buffer.left(connection.buffer.indexOf("\r\n\r\n")).split('\n');
+    QByteArray path = lines.first().split(' ').value(1);
+    QByteArray ifNoneMatch;
+    for (int i = 1; i < lines.count(); ++i) {
+        QByteArray line = lines.at(i).trimmed();
+        if (line.toLower().startsWith("if-none-match:"))
+            ifNoneMatch = line.mid(14).trimmed();
+    }
+
+    ++requests;
+    maxOpen = qMax(maxOpen, ++open);
+    connection.answering = true;
+    connection.buffer.clear();
+
+    QHash<QByteArray, Document>::const_iterator it = documents.constFind(path);
+    if (it == documents.constEnd()) {
+        connection.head = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n";
+    } else if (ifNoneMatch == it.value().etag) {
+        ++notModified;
+        connection.head = "HTTP/1.1 304 Not Modified\r\nETag: " + it.value().etag + "\r\n";
+    } else {
+        connection.head = "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\n"
+                          "ETag: " + it.value().etag + "\r\n"
+                          "Content-Length: " + QByteArray::number(it.value().body.size()) + "\r\n";
+        connection.body = it.value().body;
+    }
+    connection.head += "Connection: close\r\n\r\n";
+    connection.startAt = clock.elapsed() + (it == documents.constEnd() ? 0 : it.value().latency);
+    if (!timer.isActive())
+        timer.start();
+}
+
+// viive ja kuristus samalla ajastimella, yksi pala per yhteys per kierros
+void FeedServer::tick() {
+    qint64 now = clock.elapsed();
+    QList<QTcpSocket *> done;
+    QHash<QTcpSocket *, Connection>::iterator it;
+    bool waiting = false;
+    for (it = connections.begin(); it != connections.end(); ++it) {
+        Connection &connection = it.value();
+        if (!connection.answering)
+            continue;
+        if (now < connection.startAt) {
+            waiting = true;
+            continue;
+        }
+        QTcpSocket *socket = it.key();
+        if (!connection.headSent) {
+            socket->write(connection.head);
+            connection.headSent = true;
+        }
+        int bytes = chunkBytes > 0 ? qMin(chunkBytes, connection.body.size()) : connection.body.size();
+        if (bytes > 0) {
+            socket->write(connection.body.constData(), bytes);
+            connection.body.remove(0, bytes);
+            bytesSent += bytes;
+        }
+        if (connection.body.isEmpty())
+            done.append(socket);
+        else
+            waiting = true;
+    }
+    foreach (QTcpSocket *socket, done)
+        finish(socket);
+    if (!waiting)
+        timer.stop();
+}
+
+void FeedServer::finish(QTcpSocket *socket) {
+    connections[socket].answering = false;
+    --open;
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,99 @@
+#ifndef FEEDSERVER_H
+#define FEEDSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QByteArray>
+#include <QUrl>
+#include <QDate>
+
+class QTcpSocket;
+
+// Stand-in for the food.xml host on a loopback port. Documents are served
+// with an ETag and answer If-None-Match with 304. Every response can be
+// held back by a latency and its body trickled out a chunk per interval,
+// and the server counts requests, 304s, body bytes and the most requests
+// it had open at once. One request per connection, like a plain
+// Connection: close server.
+class FeedServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FeedServer(QObject *parent = 0);
+
+    bool listen();
+    QUrl url(const QByteArray &path) const;
+
+    // food.xml päivistä 1..days, tekstit alkavat tag:lla ja niitä
+    // pidennetään padding merkillä
+    static QByteArray menu(const QDate &monday, int days, const QByteArray &tag, int padding = 0);
+
+    void setDocument(const QByteArray &path, const QByteArray &body);
+    // vastaus alkaa vasta viiveen jälkeen
+    void setLatency(const QByteArray &path, int msecs);
+    // chunkBytes tavua per intervalMSecs, 0 lähettää kaiken kerralla
+    void setThrottle(int chunkBytes, int intervalMSecs);
+
+    inline int getRequests() const {
+        return requests;
+    }
+    inline int getNotModified() const {
+        return notModified;
+    }
+    inline qint64 getBytesSent() const {
+        return bytesSent;
+    }
+    inline int getOpen() const {
+        return open;
+    }
+    inline int getMaxOpen() const {
+        return maxOpen;
+    }
+    void resetCounters();
+
+private slots:
+    void acceptConnections();
+    void readRequest();
+    void clientDisconnected();
+    void tick();
+
+private:
+    struct Document {
+        Document() : latency(0) {}
+        QByteArray body;
+        QByteArray etag;
+        int latency;
+    };
+
+    struct Connection {
+        Connection() : startAt(0), headSent(false), answering(false) {}
+        QByteArray buffer;
+        QByteArray head;
+        QByteArray body;
+        qint64 startAt;
+        bool headSent;
+        bool answering;
+    };
+
+    void answer(QTcpSocket *socket, Connection &connection);
+    void finish(QTcpSocket *socket);
+
+    QTcpServer server;
+    QTimer timer;
+    QElapsedTimer clock;
+    QHash<QByteArray, Document> documents;
+    QHash<QTcpSocket *, Connection> connections;
+    int chunkBytes;
+    int interval;
+
+    int requests;
+    int notModified;
+    qint64 bytesSent;
+    int open;
+    int maxOpen;
+};
+
+#endif // FEEDSERVER_H
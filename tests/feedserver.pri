@@ -0,0 +1,8 @@
+# HTTP stand-in for the menu feeds.
+QT += network
+
+INCLUDEPATH += $$PWD
+
+SOURCES += $$PWD/feedserver.cpp
+
+HEADERS += $$PWD/feedserver.h
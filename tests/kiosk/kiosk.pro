@@ -0,0 +1,11 @@
+TARGET = tst_kiosk
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+include(../calendar.pri)
+
+SOURCES += tst_kiosk.cpp \
+    $$SRC/kioskserver.cpp
+
+HEADERS += $$SRC/kioskserver.h
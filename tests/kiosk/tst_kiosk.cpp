@@ -0,0 +1,269 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "kioskserver.h"
+#include "tjcalculatorbackend.h"
+
+// Load harness for the kiosk endpoint. The server runs in its own thread
+// as in the app, so the clients here can use the blocking socket calls.
+class TestKiosk : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void tjDocument();
+    void notFound();
+    void revalidation();
+    void pipelined_data();
+    void pipelined();
+    void eventsFanOut();
+    void badRequests();
+
+private:
+    struct Response {
+        QByteArray status;
+        QByteArray etag;
+        QByteArray body;
+        bool close;
+    };
+
+    QTcpSocket *connectClient();
+    bool readResponse(QTcpSocket *socket, QByteArray &buffer, Response &response);
+    Response get(const QByteArray &path, const QByteArray &extraHeaders = QByteArray());
+    void publishAndWait(const QByteArray &path, const QByteArray &json);
+
+    quint16 port;
+    KioskServer *server;
+    TjCalculatorBackend *backend;
+};
+
+static QByteArray request(const QByteArray &path, const QByteArray &extraHeaders = QByteArray()) {
+    return "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n" + extraHeaders + "\r\n";
+}
+
+void TestKiosk::initTestCase() {
+    // vapaa portti: käyttöjärjestelmä valitsee, suljetaan ja annetaan kioskille
+    QTcpServer probe;
+    QVERIFY(probe.listen(QHostAddress::LocalHost, 0));
+    port = probe.serverPort();
+    probe.close();
+
+    server = new KioskServer;
+    QVERIFY(server->start(port));
+
+    backend = new TjCalculatorBackend;
+    QSignalSpy calculated(backend, SIGNAL(calculated()));
+    QVERIFY(calculated.wait());
+    server->setBackend(backend);
+
+    publishAndWait("/doc", "{\"n\":1}");
+}
+
+void TestKiosk::cleanupTestCase() {
+    delete server;
+    delete backend;
+}
+
+QTcpSocket *TestKiosk::connectClient() {
+    QTcpSocket *socket = new QTcpSocket(this);
+    socket->connectToHost(QHostAddress::LocalHost, port);
+    if (!socket->waitForConnected(5000)) {
+        delete socket;
+        return 0;
+    }
+    return socket;
+}
+
+// yksi vastaus puskurista, loput jäävät seuraavalle
+bool TestKiosk::readResponse(QTcpSocket *socket, QByteArray &buffer, Response &response) {
+    for (;;) {
+        int headEnd = buffer.indexOf("\r\n\r\n");
+        if (headEnd >= 0) {
+            QList<QByteArray> lines = buffer.left(headEnd).split('\n');
+            int length = 0;
+            response.status = lines.first().trimmed().mid(9);
+            response.etag.clear();
+            response.close = false;
+            for (int i = 1; i < lines.count(); ++i) {
+                QByteArray line = lines.at(i).trimmed();
+                int colon = line.indexOf(':');
+                QByteArray name = line.left(colon).toLower();
+                QByteArray value = line.mid(colon + 1).trimmed();
+                if (name == "content-length")
+                    length = value.toInt();
+                else if (name == "etag")
+                    response.etag = value;
+                else if (name == "connection")
+                    response.close = value == "close";
+            }
+            if (buffer.size() >= headEnd + 4 + length) {
+                response.body = buffer.mid(headEnd + 4, length);
+                buffer.remove(0, headEnd + 4 + length);
+                return true;
+            }
+        }
+        if (!socket->waitForReadyRead(5000))
+            return false;
+        buffer += socket->readAll();
+    }
+}
+
+TestKiosk::Response TestKiosk::get(const QByteArray &path, const QByteArray &extraHeaders) {
+    Response response;
+    response.close = true;
+    QScopedPointer<QTcpSocket> socket(connectClient());
+    if (socket.isNull())
+        return response;
+    socket->write(request(path, extraHeaders));
+    QByteArray buffer;
+    if (!readResponse(socket.data(), buffer, response))
+        response.status.clear();
+    return response;
+}
+
+// julkaisu kulkee jonossa palvelinsäikeeseen
+void TestKiosk::publishAndWait(const QByteArray &path, const QByteArray &json) {
+    server->publish(path, json);
+    QTRY_COMPARE(get(path).body, json);
+}
+
+void TestKiosk::tjDocument() {
+    Response response = get("/tj");
+    QCOMPARE(response.status, QByteArray("200 OK"));
+    QJsonObject tj = QJsonDocument::fromJson(response.body).object();
+    QCOMPARE(tj.value("tjInDays").toString(), backend->getTjInDays());
+    QCOMPARE(tj.value("tjInWeeks").toString(), backend->getTjInWeeks());
+    QCOMPARE(tj.value("daysDone").toDouble(), double(backend->getDaysDone()));
+}
+
+void TestKiosk::notFound() {
+    Response response = get("/nothing");
+    QCOMPARE(response.status, QByteArray("404 Not Found"));
+    QVERIFY(response.body.isEmpty());
+}
+
+void TestKiosk::revalidation() {
+    Response first = get("/doc");
+    QCOMPARE(first.status, QByteArray("200 OK"));
+    QVERIFY(!first.etag.isEmpty());
+
+    Response again = get("/doc", "If-None-Match: " + first.etag + "\r\n");
+    QCOMPARE(again.status, QByteArray("304 Not Modified"));
+    QCOMPARE(again.etag, first.etag);
+    QVERIFY(again.body.isEmpty());
+
+    publishAndWait("/doc", "{\"n\":2}");
+    Response changed = get("/doc", "If-None-Match: " + first.etag + "\r\n");
+    QCOMPARE(changed.status, QByteArray("200 OK"));
+    QVERIFY(changed.etag != first.etag);
+    QCOMPARE(changed.body, QByteArray("{\"n\":2}"));
+}
+
+void TestKiosk::pipelined_data() {
+    QTest::addColumn<int>("clients");
+    QTest::addColumn<int>("requests");
+
+    QTest::newRow("1x500") << 1 << 500;
+    QTest::newRow("50x20") << 50 << 20;
+    QTest::newRow("200x5") << 200 << 5;
+}
+
+// kaikki pyynnöt kirjoitetaan kerralla, vastaukset luetaan järjestyksessä
+void TestKiosk::pipelined() {
+    QFETCH(int, clients);
+    QFETCH(int, requests);
+
+    QByteArray body = get("/doc").body;
+    QByteArray batch;
+    for (int i = 0; i < requests; ++i)
+        batch += request("/doc");
+
+    QList<QTcpSocket *> sockets;
+    for (int i = 0; i < clients; ++i) {
+        QTcpSocket *socket = connectClient();
+        QVERIFY(socket);
+        sockets.append(socket);
+    }
+
+    int answered = 0;
+    QBENCHMARK_ONCE {
+        foreach (QTcpSocket *socket, sockets) {
+            socket->write(batch);
+            socket->flush();
+        }
+        foreach (QTcpSocket *socket, sockets) {
+            QByteArray buffer;
+            for (int i = 0; i < requests; ++i) {
+                Response response;
+                QVERIFY(readResponse(socket, buffer, response));
+                QCOMPARE(response.status, QByteArray("200 OK"));
+                QCOMPARE(response.body, body);
+                QVERIFY(!response.close);
+                ++answered;
+            }
+            QVERIFY(buffer.isEmpty());
+        }
+    }
+    QCOMPARE(answered, clients * requests);
+    qDeleteAll(sockets);
+}
+
+void TestKiosk::eventsFanOut() {
+    const int clients = 100;
+    QList<QTcpSocket *> sockets;
+    for (int i = 0; i < clients; ++i) {
+        QTcpSocket *socket = connectClient();
+        QVERIFY(socket);
+        socket->write(request("/events"));
+        sockets.append(socket);
+    }
+    // jokainen saa ensin nykyiset dokumentit
+    foreach (QTcpSocket *socket, sockets) {
+        QByteArray buffer;
+        while (!buffer.contains("event: doc\n")) {
+            QVERIFY(socket->waitForReadyRead(5000));
+            buffer += socket->readAll();
+        }
+        QVERIFY(buffer.startsWith("HTTP/1.1 200 OK\r\n"));
+    }
+
+    QByteArray json = "{\"n\":3}";
+    server->publish("/doc", json);
+    QByteArray event = "event: doc\ndata: " + json + "\n\n";
+    foreach (QTcpSocket *socket, sockets) {
+        QByteArray buffer;
+        while (!buffer.contains(event)) {
+            QVERIFY(socket->waitForReadyRead(5000));
+            buffer += socket->readAll();
+        }
+        QCOMPARE(buffer.count(event), 1);
+    }
+    qDeleteAll(sockets);
+}
+
+void TestKiosk::badRequests() {
+    QScopedPointer<QTcpSocket> socket(connectClient());
+    QVERIFY(!socket.isNull());
+    socket->write("POST /doc HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    QByteArray buffer;
+    Response response;
+    QVERIFY(readResponse(socket.data(), buffer, response));
+    QCOMPARE(response.status, QByteArray("405 Method Not Allowed"));
+    QVERIFY(response.close);
+
+    // otsikot eivät lopu koskaan
+    socket.reset(connectClient());
+    QVERIFY(!socket.isNull());
+    socket->write("GET /doc HTTP/1.1\r\nX-Padding: " + QByteArray(9000, 'x'));
+    buffer.clear();
+    QVERIFY(readResponse(socket.data(), buffer, response));
+    QCOMPARE(response.status, QByteArray("431 Request Header Fields Too Large"));
+}
+
+QTEST_GUILESS_MAIN(TestKiosk)
+
+#include "tst_kiosk.moc"
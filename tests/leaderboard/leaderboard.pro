@@ -0,0 +1,14 @@
+TARGET = tst_leaderboard
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+
+SOURCES += tst_leaderboard.cpp \
+    $$SRC/roster.cpp \
+    $$SRC/orderstatistictree.cpp \
+    $$SRC/rosterleaderboard.cpp
+
+HEADERS += $$SRC/roster.h \
+    $$SRC/orderstatistictree.h \
+    $$SRC/rosterleaderboard.h
@@ -0,0 +1,201 @@
+#include <QtTest>
+#include <algorithm>
+#include "orderstatistictree.h"
+#include "roster.h"
+#include "rosterleaderboard.h"
+
+// Rank and select of the order statistic tree against a sorted vector,
+// and the top-k leaderboard model on a small roster.
+class TestLeaderboard : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rankAndSelect();
+    void randomAgainstSorted();
+    void reusesFreedNodes();
+    void largeTree();
+    void topK();
+    void sharedRank();
+    void movesOnChange();
+
+private:
+    static RosterEntry entry(const QString &name, const QDate &endDate);
+    static QStringList names(const RosterLeaderboard &board);
+};
+
+void TestLeaderboard::rankAndSelect() {
+    OrderStatisticTree tree;
+    QCOMPARE(tree.count(), 0);
+    QCOMPARE(tree.select(0), qint64(-1));
+    QCOMPARE(tree.countLess(10), 0);
+
+    const qint64 keys[] = { 50, 10, 40, 20, 30 };
+    for (int i = 0; i < 5; ++i)
+        tree.insert(keys[i]);
+    QCOMPARE(tree.count(), 5);
+    for (int i = 0; i < 5; ++i)
+        QCOMPARE(tree.select(i), qint64((i + 1) * 10));
+    QCOMPARE(tree.select(5), qint64(-1));
+
+    QCOMPARE(tree.countLess(10), 0);
+    QCOMPARE(tree.countLess(11), 1);
+    QCOMPARE(tree.countLess(30), 2);
+    QCOMPARE(tree.countLess(1000), 5);
+
+    tree.remove(30);
+    tree.remove(35);
+    QCOMPARE(tree.count(), 4);
+    QCOMPARE(tree.select(2), qint64(40));
+    QCOMPARE(tree.countLess(40), 2);
+
+    tree.clear();
+    QCOMPARE(tree.count(), 0);
+}
+
+// satunnaiset lisäykset ja poistot, vertailuna järjestetty taulukko
+void TestLeaderboard::randomAgainstSorted() {
+    OrderStatisticTree tree;
+    QVector<qint64> sorted;
+    qsrand(27);
+    for (int step = 0; step < 5000; ++step) {
+        qint64 key = qrand() % 2000;
+        QVector<qint64>::iterator it = std::lower_bound(sorted.begin(), sorted.end(), key);
+        bool present = it != sorted.end() && *it == key;
+        if (present && qrand() % 2) {
+            tree.remove(key);
+            sorted.erase(it);
+        } else if (!present) {
+            tree.insert(key);
+            sorted.insert(it, key);
+        }
+        QCOMPARE(tree.count(), sorted.count());
+        if (step % 50 == 0) {
+            for (int i = 0; i < sorted.count(); ++i)
+                QCOMPARE(tree.select(i), sorted.at(i));
+        }
+        int probe = qrand() % 2100;
+        QCOMPARE(tree.countLess(probe), int(std::lower_bound(sorted.begin(), sorted.end(), qint64(probe)) - sorted.begin()));
+    }
+}
+
+void TestLeaderboard::reusesFreedNodes() {
+    OrderStatisticTree tree;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 10; ++i)
+            tree.insert(round * 10 + i);
+        for (int i = 0; i < 10; ++i)
+            tree.remove(round * 10 + i);
+    }
+    QCOMPARE(tree.count(), 0);
+    tree.insert(7);
+    QCOMPARE(tree.select(0), qint64(7));
+}
+
+// sata tuhatta avainta: haku ja sijoitus pysyvät logaritmisina
+void TestLeaderboard::largeTree() {
+    const int count = 100000;
+    OrderStatisticTree tree;
+    for (int i = 0; i < count; ++i)
+        tree.insert(qint64(i) * 7919 % count);
+    QCOMPARE(tree.count(), count);
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 sum = 0;
+    for (int i = 0; i < count; ++i)
+        sum += tree.select(i) - tree.countLess(i);
+    qint64 nsecs = timer.nsecsElapsed();
+    QCOMPARE(sum, qint64(0));
+    QVERIFY2(nsecs / count < 20000, qPrintable(QString("%1 ns per query pair").arg(nsecs / count)));
+}
+
+RosterEntry TestLeaderboard::entry(const QString &name, const QDate &endDate) {
+    RosterEntry result;
+    result.name = name;
+    result.startDate = endDate.addDays(-164);
+    result.serviceDays = 165;
+    return result;
+}
+
+QStringList TestLeaderboard::names(const RosterLeaderboard &board) {
+    QStringList result;
+    for (int row = 0; row < board.rowCount(); ++row)
+        result << board.data(board.index(row), RosterLeaderboard::NameRole).toString();
+    return result;
+}
+
+void TestLeaderboard::topK() {
+    Roster roster;
+    RosterLeaderboard board(&roster);
+    board.setToday(QDate(2026, 3, 1));
+    board.setLimit(3);
+    const QDate day(2026, 6, 1);
+    roster.append(entry("E", day.addDays(40)));
+    roster.append(entry("B", day.addDays(10)));
+    roster.append(entry("D", day.addDays(30)));
+    roster.append(entry("A", day));
+    roster.append(entry("C", day.addDays(20)));
+
+    QCOMPARE(board.rowCount(), 3);
+    QCOMPARE(names(board), QStringList() << "A" << "B" << "C");
+    QCOMPARE(board.data(board.index(0), RosterLeaderboard::MorningsLeftRole).toInt(),
+             QDate(2026, 3, 1).daysTo(day) + 1);
+    QCOMPARE(board.data(board.index(2), RosterLeaderboard::RankRole).toInt(), 3);
+    QCOMPARE(board.rankOf(0), 5);
+    QCOMPARE(board.rankOf(3), 1);
+
+    board.setLimit(0);
+    QCOMPARE(names(board), QStringList() << "A" << "B" << "C" << "D" << "E");
+}
+
+// saman päivän kotiutujat jakavat sijan
+void TestLeaderboard::sharedRank() {
+    Roster roster;
+    RosterLeaderboard board(&roster);
+    const QDate day(2026, 6, 1);
+    roster.append(entry("A", day));
+    roster.append(entry("B", day.addDays(1)));
+    roster.append(entry("C", day.addDays(1)));
+    roster.append(entry("D", day.addDays(2)));
+
+    QCOMPARE(board.rankOf(0), 1);
+    QCOMPARE(board.rankOf(1), 2);
+    QCOMPARE(board.rankOf(2), 2);
+    QCOMPARE(board.rankOf(3), 4);
+}
+
+void TestLeaderboard::movesOnChange() {
+    Roster roster;
+    RosterLeaderboard board(&roster);
+    board.setLimit(2);
+    const QDate day(2026, 6, 1);
+    roster.append(entry("A", day));
+    roster.append(entry("B", day.addDays(10)));
+    roster.append(entry("C", day.addDays(20)));
+    QCOMPARE(names(board), QStringList() << "A" << "B");
+
+    // C nousee kärkeen, B putoaa listalta
+    QSignalSpy inserted(&board, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removed(&board, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    roster.update(2, entry("C", day.addDays(-5)));
+    QCOMPARE(names(board), QStringList() << "C" << "A");
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(board.rankOf(1), 3);
+
+    // listan sisällä siirto
+    QSignalSpy moved(&board, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    roster.update(0, entry("A", day.addDays(-10)));
+    QCOMPARE(names(board), QStringList() << "A" << "C");
+    QCOMPARE(moved.count(), 1);
+
+    // A putoaa listalta, B palaa
+    roster.update(0, entry("A", day.addDays(30)));
+    QCOMPARE(names(board), QStringList() << "C" << "B");
+    QCOMPARE(board.rankOf(0), 3);
+}
+
+QTEST_GUILESS_MAIN(TestLeaderboard)
+
+#include "tst_leaderboard.moc"
@@ -0,0 +1,7 @@
+TARGET = tst_mealconfig
+TEMPLATE = app
+
+include(../tests.pri)
+include(../calendar.pri)
+
+SOURCES += tst_mealconfig.cpp
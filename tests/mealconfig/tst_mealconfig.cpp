@@ -0,0 +1,166 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "mealconfig.h"
+
+// hylätyt lataukset, eli montako kertaa virheellinen tiedosto luettiin
+static int rejectedLoads = 0;
+static QtMessageHandler previousHandler = 0;
+
+static void countRejected(QtMsgType type, const QMessageLogContext &context, const QString &message) {
+    if (type == QtWarningMsg && message.contains("keeping previous schedule"))
+        ++rejectedLoads;
+    previousHandler(type, context, message);
+}
+
+// Reloading and saving of config.json. The defaults file and the
+// writable copy live in a temporary directory; the copy does not exist
+// until the first save.
+class TestMealConfig : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void loadsDefaults();
+    void keepsScheduleOnBadFile();
+    void reloadsChangedDefaults();
+    void atomicSave();
+    void reloadsReplacedCopy();
+    void ignoresOtherFiles();
+
+private:
+    static void write(const QString &path, const QByteArray &json);
+    static QJsonObject read(const QString &path);
+
+    QTemporaryDir *dir;
+    QString defaults;
+    QString copy;
+    MealConfig *config;
+};
+
+static const QByteArray DefaultJson =
+        "{\"breakfast\":\"07:00\",\"lunch\":\"11:00\",\"dinner\":\"16:00\",\"supper\":\"19:00\",\"reminder\":15}";
+
+void TestMealConfig::initTestCase() {
+    previousHandler = qInstallMessageHandler(countRejected);
+}
+
+void TestMealConfig::cleanupTestCase() {
+    qInstallMessageHandler(previousHandler);
+}
+
+void TestMealConfig::init() {
+    rejectedLoads = 0;
+    dir = new QTemporaryDir;
+    QVERIFY(QDir(dir->path()).mkdir("data"));
+    defaults = dir->path() + "/defaults.json";
+    copy = dir->path() + "/data/config.json";
+    write(defaults, DefaultJson);
+    config = new MealConfig(copy, defaults);
+}
+
+void TestMealConfig::cleanup() {
+    delete config;
+    delete dir;
+}
+
+// korvaa kokonaan kuten tallennuskin, vahti näkee poiston ja uuden tiedoston
+void TestMealConfig::write(const QString &path, const QByteArray &json) {
+    QSaveFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(json);
+    QVERIFY(file.commit());
+}
+
+QJsonObject TestMealConfig::read(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QJsonObject();
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void TestMealConfig::loadsDefaults() {
+    QCOMPARE(config->getTimes().value("lunch").toString(), QString("11:00"));
+    QCOMPARE(config->getReminderMinutes(), 15);
+    QVERIFY(!QFile::exists(copy));
+}
+
+void TestMealConfig::keepsScheduleOnBadFile() {
+    MealSchedule before = config->getSchedule();
+    QSignalSpy changed(config, SIGNAL(scheduleChanged()));
+    write(defaults, "{\"lunch\":\"25:99\"}");
+    QTRY_VERIFY(rejectedLoads > 0);
+    QVERIFY(config->getSchedule() == before);
+    QVERIFY(changed.isEmpty());
+    // virheellinenkin tiedosto pysyy vahdittuna
+    write(defaults, "{\"lunch\":\"11:30\"}");
+    QTRY_COMPARE(config->getTimes().value("lunch").toString(), QString("11:30"));
+}
+
+void TestMealConfig::reloadsChangedDefaults() {
+    QSignalSpy changed(config, SIGNAL(scheduleChanged()));
+    write(defaults, "{\"breakfast\":\"07:00\",\"lunch\":\"11:45\",\"dinner\":\"16:00\",\"supper\":\"19:00\",\"reminder\":15}");
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(config->getTimes().value("lunch").toString(), QString("11:45"));
+}
+
+// peräkkäiset muutokset yhdellä kirjoituksella, väliaikaistiedosto ei jää
+void TestMealConfig::atomicSave() {
+    config->setMealTime("lunch", 11, 30);
+    config->setMealTime("dinner", 16, 30);
+    config->setReminderMinutes(20);
+    QVERIFY(!QFile::exists(copy));
+
+    QTRY_VERIFY(QFile::exists(copy));
+    QJsonObject saved = read(copy);
+    QCOMPARE(saved.value("lunch").toString(), QString("11:30"));
+    QCOMPARE(saved.value("dinner").toString(), QString("16:30"));
+    QCOMPARE(saved.value("reminder").toInt(), 20);
+    QCOMPARE(saved.value("breakfast").toString(), QString("07:00"));
+    QCOMPARE(QDir(dir->path() + "/data").entryList(QDir::Files), QStringList() << "config.json");
+
+    // oma tallennus ei lataa vanhaa päälle
+    QTest::qWait(200);
+    QCOMPARE(config->getTimes().value("lunch").toString(), QString("11:30"));
+}
+
+// tallennus korvaa tiedoston, vahti on asetettava uudelleen joka kerta
+void TestMealConfig::reloadsReplacedCopy() {
+    config->save();
+    QVERIFY(QFile::exists(copy));
+    for (int minute = 10; minute <= 30; minute += 10) {
+        QString time = QTime(12, minute).toString("hh:mm");
+        write(copy, "{\"lunch\":\"" + time.toLatin1() + "\",\"reminder\":15}");
+        QTRY_COMPARE(config->getTimes().value("lunch").toString(), time);
+    }
+    // oletukset eivät enää vaikuta, kun kopio on olemassa
+    QSignalSpy changed(config, SIGNAL(scheduleChanged()));
+    write(defaults, "{\"lunch\":\"09:00\"}");
+    QTest::qWait(200);
+    QVERIFY(changed.isEmpty());
+}
+
+// kopion synnyttyä hakemiston muut tiedostot eivät lataa asetuksia
+void TestMealConfig::ignoresOtherFiles() {
+    config->save();
+    QVERIFY(QFile::exists(copy));
+    // virheellinen kopio: jokainen lataus näkyy varoituksena
+    write(copy, "{");
+    QTRY_VERIFY(rejectedLoads > 0);
+    QTest::qWait(200);
+
+    rejectedLoads = 0;
+    write(dir->path() + "/data/other.json", "{}");
+    QTest::qWait(200);
+    QCOMPARE(rejectedLoads, 0);
+}
+
+QTEST_GUILESS_MAIN(TestMealConfig)
+
+#include "tst_mealconfig.moc"
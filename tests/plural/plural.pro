@@ -0,0 +1,9 @@
+TARGET = tst_plural
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += tst_plural.cpp \
+    $$SRC/pluralformatter.cpp
+
+HEADERS += $$SRC/pluralformatter.h
@@ -0,0 +1,86 @@
+#include <QtTest>
+#include "pluralformatter.h"
+
+Q_DECLARE_METATYPE(PluralFormatter::Unit)
+
+// Plural forms picked from the value as printed, per unit and language.
+class TestPlural : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void format_data();
+    void format();
+    void reusesBuffer();
+};
+
+void TestPlural::format_data() {
+    QTest::addColumn<int>("language");
+    QTest::addColumn<qreal>("value");
+    QTest::addColumn<PluralFormatter::Unit>("unit");
+    QTest::addColumn<int>("decimals");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("one morning") << int(QLocale::Finnish) << qreal(1) << PluralFormatter::Morning << 0 << QString("1 aamu");
+    QTest::newRow("two mornings") << int(QLocale::Finnish) << qreal(2) << PluralFormatter::Morning << 0 << QString("2 aamua");
+    QTest::newRow("no mornings") << int(QLocale::Finnish) << qreal(0) << PluralFormatter::Morning << 0 << QString("0 aamua");
+    QTest::newRow("day") << int(QLocale::Finnish) << qreal(1) << PluralFormatter::Day << 0
+                         << QString::fromUtf8("1 päivä");
+    QTest::newRow("days") << int(QLocale::Finnish) << qreal(164.4) << PluralFormatter::Day << 0
+                          << QString::fromUtf8("164 päivää");
+    // yhden desimaalin luku tasalukuna on yksikkö
+    QTest::newRow("rounds to one month") << int(QLocale::Finnish) << qreal(0.96) << PluralFormatter::Month << 1
+                                         << QString("1 kuukausi");
+    QTest::newRow("one month exactly") << int(QLocale::Finnish) << qreal(1) << PluralFormatter::Month << 1
+                                       << QString("1 kuukausi");
+    QTest::newRow("half a month") << int(QLocale::Finnish) << qreal(0.5) << PluralFormatter::Month << 1
+                                  << QString("0,5 kuukautta");
+    QTest::newRow("weeks") << int(QLocale::Finnish) << qreal(2.54) << PluralFormatter::Week << 1 << QString("2,5 viikkoa");
+    QTest::newRow("whole weeks") << int(QLocale::Finnish) << qreal(2.04) << PluralFormatter::Week << 1 << QString("2 viikkoa");
+    QTest::newRow("leading zero") << int(QLocale::Finnish) << qreal(1.007) << PluralFormatter::Hour << 2
+                                  << QString("1,01 tuntia");
+    QTest::newRow("three decimals") << int(QLocale::Finnish) << qreal(3.14159) << PluralFormatter::Hour << 3
+                                    << QString("3,142 tuntia");
+    QTest::newRow("negative one") << int(QLocale::Finnish) << qreal(-1) << PluralFormatter::Day << 0
+                                  << QString::fromUtf8("-1 päivä");
+    QTest::newRow("negative zero") << int(QLocale::Finnish) << qreal(-0.04) << PluralFormatter::Week << 1
+                                   << QString("0 viikkoa");
+    QTest::newRow("english one") << int(QLocale::English) << qreal(1) << PluralFormatter::Morning << 0 << QString("1 morning");
+    QTest::newRow("english weeks") << int(QLocale::English) << qreal(2.5) << PluralFormatter::Week << 1 << QString("2.5 weeks");
+    // taulukotonta kieltä ei ole, suomi on oletus
+    QTest::newRow("fallback") << int(QLocale::Swedish) << qreal(3) << PluralFormatter::Morning << 0 << QString("3 aamua");
+}
+
+void TestPlural::format() {
+    QFETCH(int, language);
+    QFETCH(qreal, value);
+    QFETCH(PluralFormatter::Unit, unit);
+    QFETCH(int, decimals);
+    QFETCH(QString, expected);
+
+    PluralFormatter plural(QLocale::Language(language));
+    QCOMPARE(plural.format(value, unit, decimals), expected);
+}
+
+// sama puskuri kelpaa uudelleen ilman uutta varausta
+void TestPlural::reusesBuffer() {
+    PluralFormatter plural;
+    QString out;
+    out.reserve(64);
+    const QChar *data = out.constData();
+    int capacity = out.capacity();
+
+    for (int days = 200; days >= 0; --days) {
+        plural.format(out, days, PluralFormatter::Morning);
+        QCOMPARE(out.constData(), data);
+    }
+    QCOMPARE(out, QString("0 aamua"));
+    QCOMPARE(out.capacity(), capacity);
+
+    plural.format(out, 1, PluralFormatter::Morning);
+    QCOMPARE(out, QString("1 aamu"));
+}
+
+QTEST_GUILESS_MAIN(TestPlural)
+
+#include "tst_plural.moc"
@@ -0,0 +1,15 @@
+TARGET = tst_reminders
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+include(../calendar.pri)
+
+QT += dbus
+
+SOURCES += tst_reminders.cpp \
+    $$SRC/reminderengine.cpp \
+    $$SRC/remindersink.cpp
+
+HEADERS += $$SRC/reminderengine.h \
+    $$SRC/remindersink.h
@@ -0,0 +1,184 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "reminderengine.h"
+#include "remindersink.h"
+#include "qfoodcalendar.h"
+#include "mealconfig.h"
+#include "wakeupscheduler.h"
+
+// simuloitu seinäkello, ajastin ajetaan käsin sen mukaan
+static qint64 fakeNow = 0;
+
+static qint64 fakeClock() {
+    return fakeNow;
+}
+
+// LogReminderSinkin rivit ja kello niiden kirjoitushetkellä
+struct Delivery {
+    QDateTime at;
+    QString line;
+};
+
+static QList<Delivery> deliveries;
+static QtMessageHandler previousHandler = 0;
+
+static void captureReminders(QtMsgType type, const QMessageLogContext &context, const QString &message) {
+    if (type == QtDebugMsg && message.startsWith("reminder: ")) {
+        Delivery delivery;
+        delivery.at = QDateTime::fromMSecsSinceEpoch(fakeNow);
+        delivery.line = message.mid(10);
+        deliveries.append(delivery);
+        return;
+    }
+    previousHandler(type, context, message);
+}
+
+// The reminder engine against LogReminderSink on a simulated clock. The
+// calendar has no feeds; its meal index still yields the configured meal
+// times. As in tst_wakeups, the test jumps the clock to where the
+// scheduler armed it and runs the wakeup itself.
+class TestReminders : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void onePerMeal();
+    void rebuildInsideLeadWindow();
+    void mergesIntoLaterDeadline();
+    void neverEarly();
+
+private:
+    void configure(const QByteArray &json);
+    void runUntil(const QDateTime &end);
+
+    QTemporaryDir *dir;
+    MealConfig *config;
+    QFoodCalendar *calendar;
+};
+
+void TestReminders::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    WakeupScheduler::instance()->setClock(fakeClock);
+    previousHandler = qInstallMessageHandler(captureReminders);
+}
+
+void TestReminders::cleanupTestCase() {
+    qInstallMessageHandler(previousHandler);
+    WakeupScheduler::instance()->setClock(0);
+}
+
+void TestReminders::init() {
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).removeRecursively();
+    // tammikuussa ei kesäajan vaihtoa
+    fakeNow = QDateTime(QDate(2026, 1, 12), QTime(6, 0)).toMSecsSinceEpoch();
+    deliveries.clear();
+    dir = new QTemporaryDir;
+    config = 0;
+    calendar = 0;
+}
+
+void TestReminders::cleanup() {
+    delete calendar;
+    delete config;
+    delete dir;
+}
+
+// asennettu oletus on testin tiedosto, kirjoitettavaa kopiota ei ole
+void TestReminders::configure(const QByteArray &json) {
+    QFile defaults(dir->path() + "/defaults.json");
+    QVERIFY(defaults.open(QIODevice::WriteOnly));
+    defaults.write(json);
+    defaults.close();
+    config = new MealConfig(dir->path() + "/config.json", defaults.fileName());
+    calendar = new QFoodCalendar;
+    calendar->setMealConfig(config);
+}
+
+void TestReminders::runUntil(const QDateTime &end) {
+    qint64 last = end.toMSecsSinceEpoch();
+    for (;;) {
+        qint64 next = WakeupScheduler::instance()->getNextWakeup();
+        if (next < 0 || next >= last)
+            break;
+        fakeNow = qMax(next, fakeNow);
+        QMetaObject::invokeMethod(WakeupScheduler::instance(), "wakeup");
+    }
+    fakeNow = last;
+}
+
+void TestReminders::onePerMeal() {
+    configure("{\"breakfast\":\"07:00\",\"lunch\":\"11:00\",\"dinner\":\"16:00\",\"supper\":\"19:00\",\"reminder\":15}");
+    ReminderEngine engine(calendar, config, new LogReminderSink);
+    QDate day(2026, 1, 12);
+    runUntil(QDateTime(day.addDays(1), QTime(0, 0)));
+
+    QCOMPARE(deliveries.count(), 4);
+    QCOMPARE(deliveries.at(0).at, QDateTime(day, QTime(6, 45)));
+    QCOMPARE(deliveries.at(1).at, QDateTime(day, QTime(10, 45)));
+    QCOMPARE(deliveries.at(2).at, QDateTime(day, QTime(15, 45)));
+    QCOMPARE(deliveries.at(3).at, QDateTime(day, QTime(18, 45)));
+    QVERIFY(deliveries.at(0).line.contains("Aamupala 7:00"));
+    QVERIFY(deliveries.at(1).line.contains("Lounas 11:00"));
+    QVERIFY(deliveries.at(3).line.contains("Iltapala 19:00"));
+}
+
+// menu päivittyy muistutushetken ja aterian alun välissä: lounas
+// muistutetaan heti eikä vain kerran
+void TestReminders::rebuildInsideLeadWindow() {
+    configure("{\"breakfast\":\"07:00\",\"lunch\":\"11:00\",\"dinner\":\"16:00\",\"supper\":\"19:00\",\"reminder\":15}");
+    QDate day(2026, 1, 12);
+    fakeNow = QDateTime(day, QTime(10, 50)).toMSecsSinceEpoch();
+    ReminderEngine engine(calendar, config, new LogReminderSink);
+    QCOMPARE(engine.getQueue().first().mealStart, QDateTime(day, QTime(11, 0)));
+
+    runUntil(QDateTime(day, QTime(10, 52)));
+    QCOMPARE(deliveries.count(), 1);
+    QCOMPARE(deliveries.first().at, QDateTime(day, QTime(10, 50)));
+    QVERIFY(deliveries.first().line.contains("Lounas 11:00"));
+
+    // uusi rakennus samassa ikkunassa ei toista muistutusta
+    engine.rebuild();
+    QCOMPARE(engine.getQueue().first().mealStart, QDateTime(day, QTime(16, 0)));
+    runUntil(QDateTime(day, QTime(15, 0)));
+    QCOMPARE(deliveries.count(), 1);
+}
+
+// muistutukset 10:45 ja 10:50 samalla herätyksellä myöhemmän kohdalla
+void TestReminders::mergesIntoLaterDeadline() {
+    configure("{\"breakfast\":\"07:00\",\"lunch\":\"11:00\",\"dinner\":\"11:05\",\"supper\":\"19:00\",\"reminder\":15}");
+    QDate day(2026, 1, 12);
+    fakeNow = QDateTime(day, QTime(10, 0)).toMSecsSinceEpoch();
+    ReminderEngine engine(calendar, config, new LogReminderSink);
+    QCOMPARE(WakeupScheduler::instance()->getNextWakeup(), QDateTime(day, QTime(10, 50)).toMSecsSinceEpoch());
+
+    runUntil(QDateTime(day, QTime(12, 0)));
+    QCOMPARE(deliveries.count(), 2);
+    QCOMPARE(deliveries.at(0).at, QDateTime(day, QTime(10, 50)));
+    QCOMPARE(deliveries.at(1).at, QDateTime(day, QTime(10, 50)));
+    QVERIFY(deliveries.at(0).line.contains("Lounas 11:00"));
+    QVERIFY(deliveries.at(1).line.contains(QString::fromUtf8("Päivällinen 11:05")));
+}
+
+// ei ennen omaa muistutushetkeä, eikä yhdistämisen takia aterian alun jälkeen
+void TestReminders::neverEarly() {
+    configure("{\"breakfast\":\"07:00\",\"lunch\":\"07:05\",\"dinner\":\"07:15\",\"supper\":\"07:20\",\"reminder\":15}");
+    QDate day(2026, 1, 12);
+    ReminderEngine engine(calendar, config, new LogReminderSink);
+    QList<Reminder> expected = engine.getQueue().mid(0, 4);
+
+    runUntil(QDateTime(day, QTime(8, 0)));
+    QCOMPARE(deliveries.count(), 4);
+    for (int i = 0; i < deliveries.count(); ++i) {
+        QVERIFY(deliveries.at(i).at >= expected.at(i).at);
+        QVERIFY(deliveries.at(i).at <= expected.at(i).mealStart);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestReminders)
+
+#include "tst_reminders.moc"
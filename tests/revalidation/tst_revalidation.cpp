@@ -0,0 +1,137 @@
+#include <QtTest>
+#include <QDir>
+#include <QStandardPaths>
+#include "qfoodcalendar.h"
+#include "feedserver.h"
+
+// Disk cache and conditional GET against a stand-in that counts body
+// bytes and 304s: an unchanged feed costs a 304 and no rows move, a
+// changed one is downloaded once and becomes the new cache entry.
+class TestRevalidation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cachedThenNotModified();
+    void reloadNotModified();
+    void changedFeedReplacesCache();
+
+private:
+    void loadOnce(const QByteArray &xml);
+
+    FeedServer server;
+    QDate monday;
+};
+
+void TestRevalidation::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<QVector<int> >();
+    QVERIFY(server.listen());
+    QDate today = QDate::currentDate();
+    monday = today.addDays(1 - today.dayOfWeek());
+}
+
+void TestRevalidation::init() {
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).removeRecursively();
+}
+
+// täytetään välimuisti ja nollataan laskurit
+void TestRevalidation::loadOnce(const QByteArray &xml) {
+    server.setDocument("/food.xml", xml);
+    server.resetCounters();
+    QFoodCalendar model;
+    model.setSource(server.url("/food.xml"));
+    QTRY_COMPARE(int(model.getStatus()), int(QFoodCalendar::Ready));
+    QTRY_COMPARE(server.getOpen(), 0);
+    QCOMPARE(server.getRequests(), 1);
+    QCOMPARE(server.getBytesSent(), qint64(xml.size()));
+    server.resetCounters();
+}
+
+void TestRevalidation::cachedThenNotModified() {
+    loadOnce(FeedServer::menu(monday, 5, "v1"));
+
+    QFoodCalendar model;
+    model.setSource(server.url("/food.xml"));
+    // välimuistista heti, ennen kuin verkosta on kuultu mitään
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(int(model.getStatus()), int(QFoodCalendar::Ready));
+    QCOMPARE(model.data(model.index(0), QFoodCalendar::LunchRole).toString(), QString("v1 lunch 1"));
+
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QTRY_COMPARE(server.getNotModified(), 1);
+    QTRY_COMPARE(server.getOpen(), 0);
+    QTest::qWait(100);
+
+    QCOMPARE(server.getRequests(), 1);
+    QCOMPARE(server.getBytesSent(), qint64(0));
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(model.rowCount(), 5);
+}
+
+void TestRevalidation::reloadNotModified() {
+    QByteArray xml = FeedServer::menu(monday, 5, "v1");
+    server.setDocument("/food.xml", xml);
+    QFoodCalendar model;
+    model.setSource(server.url("/food.xml"));
+    QTRY_COMPARE(int(model.getStatus()), int(QFoodCalendar::Ready));
+    QTRY_COMPARE(server.getOpen(), 0);
+    server.resetCounters();
+
+    // sama malli: etag tulee edellisestä vastauksesta
+    QSignalSpy reset(&model, SIGNAL(modelReset()));
+    model.reload();
+    QTRY_COMPARE(server.getNotModified(), 1);
+    QTRY_COMPARE(server.getOpen(), 0);
+    QCOMPARE(server.getBytesSent(), qint64(0));
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(model.rowCount(), 5);
+}
+
+void TestRevalidation::changedFeedReplacesCache() {
+    loadOnce(FeedServer::menu(monday, 5, "v1"));
+    QByteArray fresh = FeedServer::menu(monday, 6, "v2");
+    server.setDocument("/food.xml", fresh);
+
+    {
+        QFoodCalendar model;
+        QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+        QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+        QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+        model.setSource(server.url("/food.xml"));
+        QCOMPARE(model.rowCount(), 5);
+
+        // vanha lista näkyy kunnes uusi on kokonainen, sitten erotus
+        QTRY_COMPARE(model.rowCount(), 6);
+        QCOMPARE(server.getNotModified(), 0);
+        QCOMPARE(server.getBytesSent(), qint64(fresh.size()));
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(removed.count(), 0);
+        QCOMPARE(changed.count(), 5);
+        for (int row = 0; row < 6; ++row) {
+            QModelIndex index = model.index(row);
+            QCOMPARE(model.data(index, QFoodCalendar::LunchRole).toString(), QString("v2 lunch %1").arg(row + 1));
+            QVERIFY(model.data(index, QFoodCalendar::ChangedRole).toBool());
+        }
+        QTRY_COMPARE(server.getOpen(), 0);
+    }
+
+    // uusi lista ja sen etag jäivät välimuistiin
+    server.resetCounters();
+    QFoodCalendar model;
+    model.setSource(server.url("/food.xml"));
+    QCOMPARE(model.rowCount(), 6);
+    QTRY_COMPARE(server.getNotModified(), 1);
+    QCOMPARE(server.getBytesSent(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestRevalidation)
+
+#include "tst_revalidation.moc"
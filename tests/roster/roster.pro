@@ -0,0 +1,11 @@
+TARGET = tst_roster
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += tst_roster.cpp \
+    $$SRC/roster.cpp \
+    $$SRC/rosterimporter.cpp
+
+HEADERS += $$SRC/roster.h \
+    $$SRC/rosterimporter.h
@@ -0,0 +1,155 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "roster.h"
+#include "rosterimporter.h"
+
+// RosterImporter on small CSV and JSON files written to a temporary
+// directory, and the leave periods in Roster::morningsLeft().
+class TestRoster : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void arrivalDate();
+    void csv();
+    void json();
+    void longRow();
+    void leavesLeft();
+    void throughput();
+
+private:
+    QString write(const QString &name, const QByteArray &data);
+
+    QTemporaryDir dir;
+};
+
+QString TestRoster::write(const QString &name, const QByteArray &data) {
+    QString path = dir.path() + '/' + name;
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly))
+        file.write(data);
+    return path;
+}
+
+// erä I tammikuun ja erä II heinäkuun ensimmäisenä maanantaina
+void TestRoster::arrivalDate() {
+    QCOMPARE(RosterImporter::arrivalDate(1, 2014), QDate(2014, 1, 6));
+    QCOMPARE(RosterImporter::arrivalDate(2, 2014), QDate(2014, 7, 7));
+    QCOMPARE(RosterImporter::arrivalDate(1, 2024), QDate(2024, 1, 1));
+    QVERIFY(!RosterImporter::arrivalDate(3, 2014).isValid());
+}
+
+void TestRoster::csv() {
+    QString path = write("roster.csv",
+                         "\xEF\xBB\xBFnimi,erä,palvelus,lomat\n"
+                         "Virtanen,1/14,165,3.3.2014-7.3.2014;5.5.2014-9.5.2014\r\n"
+                         "\"Korhonen, Matti\",II/14,347\n"
+                         "\n"
+                         "Nieminen,2/2014,255,2014-08-04..2014-08-08\n"
+                         "Rikki,3/14,165\n"
+                         "Lomaton,1/14,165,7.3.2014-3.3.2014\n"
+                         "Mäkinen,1/14,165");
+    Roster roster;
+    RosterImporter importer;
+    QSignalSpy finished(&importer, SIGNAL(finished(int,qint64)));
+    QVERIFY(importer.importFile(path, &roster));
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(importer.importedRows(), 4);
+    QCOMPARE(importer.skippedRows(), 2);
+    QCOMPARE(roster.count(), 4);
+
+    QCOMPARE(roster.entry(0).name, QString("Virtanen"));
+    QCOMPARE(roster.entry(0).startDate, QDate(2014, 1, 6));
+    QCOMPARE(roster.entry(0).endDate(), QDate(2014, 6, 19));
+    QCOMPARE(roster.entry(0).leaves.count(), 2);
+    QCOMPARE(roster.entry(0).leaves.at(1).first, QDate(2014, 5, 5));
+    QCOMPARE(roster.entry(0).leaves.at(1).last, QDate(2014, 5, 9));
+
+    QCOMPARE(roster.entry(1).name, QString("Korhonen, Matti"));
+    QCOMPARE(roster.entry(1).startDate, QDate(2014, 7, 7));
+    QCOMPARE(roster.entry(1).serviceDays, 347);
+    QVERIFY(roster.entry(1).leaves.isEmpty());
+
+    QCOMPARE(roster.entry(2).leaves.count(), 1);
+    QCOMPARE(roster.entry(2).leaves.first().first, QDate(2014, 8, 4));
+    QCOMPARE(roster.entry(3).name, QString::fromUtf8("Mäkinen"));
+}
+
+void TestRoster::json() {
+    QString path = write("roster.json",
+                         "[{\"name\": \"Virtanen\", \"batch\": \"1/14\", \"service\": 165,"
+                         " \"leaves\": \"3.3.2014-7.3.2014\"},\n"
+                         " {\"service\": 347, \"name\": \"Lahtinen \\\"Late\\\"\", \"batch\": \"II/14\","
+                         " \"leaves\": [\"2014-08-04..2014-08-08\", \"1.9.2014-2.9.2014\"], \"extra\": {\"a\": [1, 2]}},\n"
+                         " {\"name\": \"Ilman palvelusta\", \"batch\": \"1/14\"},\n"
+                         " {\"name\": \"J\\u00e4rvinen\", \"batch\": \"1/14\", \"service\": 255}]\n");
+    Roster roster;
+    RosterImporter importer;
+    QVERIFY(importer.importFile(path, &roster));
+    QCOMPARE(importer.importedRows(), 3);
+    QCOMPARE(importer.skippedRows(), 1);
+
+    QCOMPARE(roster.entry(0).leaves.count(), 1);
+    QCOMPARE(roster.entry(0).leaves.first().last, QDate(2014, 3, 7));
+    QCOMPARE(roster.entry(1).name, QString("Lahtinen \"Late\""));
+    QCOMPARE(roster.entry(1).startDate, QDate(2014, 7, 7));
+    QCOMPARE(roster.entry(1).leaves.count(), 2);
+    QCOMPARE(roster.entry(1).leaves.at(1).first, QDate(2014, 9, 1));
+    QCOMPARE(roster.entry(2).name, QString::fromUtf8("Järvinen"));
+    QCOMPARE(roster.entry(2).serviceDays, 255);
+}
+
+// rivi on pidempi kuin lukuikkuna
+void TestRoster::longRow() {
+    QByteArray name(200 * 1024, 'x');
+    QString path = write("long.csv", "Alku,1/14,165\n" + name + ",1/14,165\nLoppu,1/14,165\n");
+    Roster roster;
+    RosterImporter importer;
+    QVERIFY(importer.importFile(path, &roster));
+    QCOMPARE(roster.count(), 3);
+    QCOMPARE(roster.entry(1).name.size(), name.size());
+    QCOMPARE(roster.entry(2).name, QString("Loppu"));
+}
+
+// vain tänään ja myöhemmin olevat lomapäivät vähennetään
+void TestRoster::leavesLeft() {
+    Roster roster;
+    RosterImporter importer;
+    QVERIFY(importer.importFile(write("leaves.csv",
+                                      "Virtanen,1/14,165,3.3.2014-7.3.2014;5.5.2014-9.5.2014\n"
+                                      "Korhonen,1/14,165\n"), &roster));
+    QDate today(2014, 3, 5);
+    QCOMPARE(roster.morningsLeft(1, today), 107);
+    QCOMPARE(roster.entry(0).leaveDays(today, roster.entry(0).endDate()), 3 + 5);
+    QCOMPARE(roster.morningsLeft(0, today), 107 - 8);
+    QCOMPARE(roster.morningsLeft(0, QDate(2014, 5, 10)), roster.morningsLeft(1, QDate(2014, 5, 10)));
+    // kotiutuspäivä ei siirry
+    QCOMPARE(roster.entry(0).endDate(), roster.entry(1).endDate());
+}
+
+void TestRoster::throughput() {
+    const int count = 20000;
+    QByteArray csv = "name,batch,service,leaves\n";
+    for (int i = 0; i < count; ++i)
+        csv += "Sotilas " + QByteArray::number(i) + (i % 2 ? ",1/14,165," : ",II/14,347,")
+                + "3.3.2014-7.3.2014\n";
+    QString path = write("big.csv", csv);
+
+    Roster roster;
+    RosterImporter importer;
+    QSignalSpy progress(&importer, SIGNAL(progress(qint64,qint64)));
+    QSignalSpy finished(&importer, SIGNAL(finished(int,qint64)));
+    QVERIFY(importer.importFile(path, &roster));
+    QCOMPARE(roster.count(), count);
+    QCOMPARE(importer.skippedRows(), 0);
+    QVERIFY(progress.count() > 1);
+    QCOMPARE(progress.last().at(0).toLongLong(), qint64(csv.size()));
+    QCOMPARE(finished.first().at(0).toInt(), count);
+    // satoja tuhansia rivejä sekunnissa, tässä reilusti varaa
+    QVERIFY2(finished.first().at(1).toLongLong() < 1000,
+             qPrintable(QString("%1 ms").arg(finished.first().at(1).toLongLong())));
+}
+
+QTEST_GUILESS_MAIN(TestRoster)
+
+#include "tst_roster.moc"
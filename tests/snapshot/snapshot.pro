@@ -0,0 +1,16 @@
+TARGET = tst_snapshot
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += tst_snapshot.cpp \
+    $$SRC/menusnapshot.cpp \
+    $$SRC/menucache.cpp \
+    $$SRC/menuparser.cpp \
+    $$SRC/dishpool.cpp
+
+HEADERS += $$SRC/menusnapshot.h \
+    $$SRC/menucache.h \
+    $$SRC/menuparser.h \
+    $$SRC/dishpool.h \
+    $$SRC/menuday.h
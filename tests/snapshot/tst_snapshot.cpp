@@ -0,0 +1,302 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <limits>
+#include "menusnapshot.h"
+#include "menucache.h"
+#include "menuparser.h"
+#include "dishpool.h"
+
+// päivätaulukon rivi: päivä, nimi ja neljä ateriaa, kukin 32-bittinen
+static const qint64 DayRecordSize = 4 + 4 + MealSlotCount * 4;
+static const qint64 HeaderSize = 20;
+
+// The binary menu snapshot and the per-feed cache built on it: round
+// trips, damaged files, startup time against reparsing the XML, and that
+// the file stays flat while the same dishes repeat.
+class TestSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void roundTrip();
+    void outOfRange();
+    void corruptOffset();
+    void rejectsDamagedHeader();
+    void cacheRoundTrip();
+    void cacheSkipsEmpty();
+    void startupTime();
+    void flatAsDishesRepeat();
+
+private:
+    static QVector<MenuEntry> generate(const QDate &first, int dayCount, DishPool &pool);
+    static QByteArray xml(const QDate &first, int weeks);
+    static void patch(const QString &fileName, qint64 offset, quint32 value);
+
+    QTemporaryDir *dir;
+    QString fileName;
+};
+
+static const char *const Dishes[] = {
+    "Kaurapuuro", "Hernekeitto", "Makaronilaatikko", "Lihakeitto", "Kalakeitto",
+    "Jauhelihakastike ja perunat", "Broileripasta", "Lihapullat ja muusi", "Jäätelö"
+};
+static const int DishCount = sizeof(Dishes) / sizeof(Dishes[0]);
+
+static QString dish(int day, int slot) {
+    return QString::fromUtf8(Dishes[(day + slot * 2) % DishCount]);
+}
+
+void TestSnapshot::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestSnapshot::init() {
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+    dir = new QTemporaryDir;
+    fileName = dir->path() + "/test.menu";
+}
+
+void TestSnapshot::cleanup() {
+    delete dir;
+}
+
+QVector<MenuEntry> TestSnapshot::generate(const QDate &first, int dayCount, DishPool &pool) {
+    QVector<MenuEntry> days;
+    for (int i = 0; i < dayCount; ++i) {
+        MenuEntry day;
+        day.date = first.addDays(i);
+        day.name = pool.intern(QString::number(day.date.dayOfWeek()));
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            day.meals[slot] = pool.intern(dish(i, slot));
+        days.append(day);
+    }
+    return days;
+}
+
+// sama sisältö food.xml-muodossa, viikko kerrallaan
+QByteArray TestSnapshot::xml(const QDate &first, int weeks) {
+    static const char *const meals[] = { "breakfast", "lunch", "dinner", "supper" };
+    QByteArray result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<menu>\n";
+    for (int week = 0; week < weeks; ++week) {
+        result += "<week start=\"" + first.addDays(week * 7).toString(Qt::ISODate).toLatin1() + "\">\n";
+        for (int day = 1; day <= 7; ++day) {
+            result += "<day name=\"" + QByteArray::number(day) + "\">";
+            for (int slot = 0; slot < MealSlotCount; ++slot) {
+                result += QByteArray("<") + meals[slot] + '>' + dish(week * 7 + day - 1, slot).toUtf8()
+                        + "</" + meals[slot] + '>';
+            }
+            result += "</day>\n";
+        }
+        result += "</week>\n";
+    }
+    result += "</menu>\n";
+    return result;
+}
+
+void TestSnapshot::patch(const QString &fileName, qint64 offset, quint32 value) {
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(offset));
+    QCOMPARE(file.write(reinterpret_cast<const char *>(&value), sizeof(value)), qint64(sizeof(value)));
+}
+
+void TestSnapshot::roundTrip() {
+    DishPool pool;
+    QVector<MenuEntry> days = generate(QDate(2026, 3, 2), 14, pool);
+    days[3].meals[Supper] = 0;
+    days[4].date = QDate();
+    QVERIFY(MenuSnapshot::write(fileName, days, pool));
+
+    MenuSnapshot snapshot;
+    QVERIFY(snapshot.open(fileName));
+    QCOMPARE(snapshot.dayCount(), 14);
+    for (int i = 0; i < days.count(); ++i) {
+        QCOMPARE(snapshot.date(i), days.at(i).date);
+        QCOMPARE(snapshot.name(i), pool.text(days.at(i).name));
+        for (int slot = 0; slot < MealSlotCount; ++slot)
+            QCOMPARE(snapshot.meal(i, slot), pool.text(days.at(i).meals[slot]));
+    }
+    QVERIFY(snapshot.meal(3, Supper).isEmpty());
+    QVERIFY(!snapshot.date(4).isValid());
+    QCOMPARE(snapshot.meal(0, Dinner), dish(0, Dinner));
+}
+
+void TestSnapshot::outOfRange() {
+    DishPool pool;
+    QVERIFY(MenuSnapshot::write(fileName, generate(QDate(2026, 3, 2), 7, pool), pool));
+    MenuSnapshot snapshot;
+    QVERIFY(snapshot.open(fileName));
+    QVERIFY(!snapshot.date(-1).isValid());
+    QVERIFY(!snapshot.date(7).isValid());
+    QVERIFY(snapshot.name(7).isNull());
+    QVERIFY(snapshot.meal(0, -1).isNull());
+    QVERIFY(snapshot.meal(0, MealSlotCount).isNull());
+
+    // avaamaton tilannekuva on tyhjä
+    MenuSnapshot closed;
+    QCOMPARE(closed.dayCount(), 0);
+    QVERIFY(closed.meal(0, Lunch).isNull());
+}
+
+// rikkinäinen offset tai pituus ei saa lukea poolin ohi
+void TestSnapshot::corruptOffset() {
+    DishPool pool;
+    QVERIFY(MenuSnapshot::write(fileName, generate(QDate(2026, 3, 2), 7, pool), pool));
+    qint64 poolOffset = HeaderSize + 7 * DayRecordSize;
+    qint64 poolSize = QFileInfo(fileName).size() - poolOffset;
+    qint64 firstMeal = HeaderSize + 8;
+    patch(fileName, firstMeal, 0xfffffff0);
+    patch(fileName, firstMeal + 4, quint32(poolSize));
+    // poolin ensimmäinen merkkijono on ensimmäisen päivän nimi
+    patch(fileName, poolOffset, 0x7fffffff);
+
+    MenuSnapshot snapshot;
+    QVERIFY(snapshot.open(fileName));
+    QVERIFY(snapshot.meal(0, Breakfast).isNull());
+    QVERIFY(snapshot.meal(0, Lunch).isNull());
+    QVERIFY(snapshot.name(0).isNull());
+    QCOMPARE(snapshot.meal(0, Dinner), dish(0, Dinner));
+    QCOMPARE(snapshot.meal(1, Lunch), dish(1, Lunch));
+    QCOMPARE(snapshot.name(1), QString("2"));
+}
+
+void TestSnapshot::rejectsDamagedHeader() {
+    DishPool pool;
+    QVERIFY(MenuSnapshot::write(fileName, generate(QDate(2026, 3, 2), 7, pool), pool));
+    QByteArray original;
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        original = file.readAll();
+    }
+
+    // taikaluku, versio, päivien määrä ja poolin koko
+    const qint64 offsets[] = { 0, 4, 8, 16 };
+    const quint32 values[] = { 0x21212121, 2, 1000000, 1000000 };
+    for (int i = 0; i < 4; ++i) {
+        {
+            QFile file(fileName);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(original);
+        }
+        patch(fileName, offsets[i], values[i]);
+        MenuSnapshot snapshot;
+        QVERIFY2(!snapshot.open(fileName), qPrintable(QString("field at %1").arg(offsets[i])));
+        QCOMPARE(snapshot.dayCount(), 0);
+    }
+
+    QFile truncated(fileName);
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    truncated.write(original.left(HeaderSize - 1));
+    truncated.close();
+    MenuSnapshot snapshot;
+    QVERIFY(!snapshot.open(fileName));
+}
+
+void TestSnapshot::cacheRoundTrip() {
+    QUrl source("http://localhost/food.xml");
+    DishPool pool;
+    QVector<MenuEntry> days = generate(QDate(2026, 3, 2), 7, pool);
+    {
+        MenuCache cache(source);
+        QVERIFY(!cache.load());
+        QVERIFY(cache.store(days, pool, "\"abc\"", "Mon, 02 Mar 2026 08:00:00 GMT"));
+    }
+
+    MenuCache cache(source);
+    QVERIFY(cache.load());
+    QCOMPARE(cache.getETag(), QByteArray("\"abc\""));
+    QCOMPARE(cache.getLastModified(), QByteArray("Mon, 02 Mar 2026 08:00:00 GMT"));
+    QScopedPointer<MenuSnapshot> snapshot(cache.takeSnapshot());
+    QVERIFY(!snapshot.isNull());
+    QCOMPARE(snapshot->dayCount(), 7);
+    QCOMPARE(snapshot->meal(6, Lunch), pool.text(days.at(6).meals[Lunch]));
+
+    // eri syötteellä oma välimuisti
+    MenuCache other(QUrl("http://localhost/other.xml"));
+    QVERIFY(!other.load());
+}
+
+// tyhjää listaa ei näytetä välimuistista
+void TestSnapshot::cacheSkipsEmpty() {
+    QUrl source("http://localhost/food.xml");
+    DishPool pool;
+    {
+        MenuCache cache(source);
+        QVERIFY(cache.store(QVector<MenuEntry>(), pool, "\"empty\"", QByteArray()));
+    }
+    MenuCache cache(source);
+    QVERIFY(!cache.load());
+    QVERIFY(!cache.takeSnapshot());
+}
+
+// vuoden menu: ensimmäinen rivi tilannekuvasta nopeammin kuin XML:stä
+void TestSnapshot::startupTime() {
+    const QDate first(2025, 1, 6);
+    const int weeks = 52;
+    QByteArray document = xml(first, weeks);
+    DishPool pool;
+    QVERIFY(MenuSnapshot::write(fileName, generate(first, weeks * 7, pool), pool));
+
+    qint64 parseNsecs = std::numeric_limits<qint64>::max();
+    qint64 mapNsecs = std::numeric_limits<qint64>::max();
+    QElapsedTimer timer;
+    for (int round = 0; round < 5; ++round) {
+        timer.start();
+        MenuParser parser;
+        parser.addData(document);
+        QVERIFY(parser.parse());
+        QVector<MenuDay> days = parser.takeDays();
+        DishPool parsedPool;
+        QVector<MenuEntry> entries(days.count());
+        for (int i = 0; i < days.count(); ++i) {
+            entries[i].date = days.at(i).date;
+            entries[i].name = parsedPool.intern(days.at(i).name);
+            for (int slot = 0; slot < MealSlotCount; ++slot)
+                entries[i].meals[slot] = parsedPool.intern(days.at(i).meals[slot]);
+        }
+        QString parsedRow = parsedPool.text(entries.first().meals[Lunch]);
+        parseNsecs = qMin(parseNsecs, timer.nsecsElapsed());
+        QCOMPARE(days.count(), weeks * 7);
+
+        timer.start();
+        MenuSnapshot snapshot;
+        QVERIFY(snapshot.open(fileName));
+        QString mappedRow = snapshot.meal(0, Lunch);
+        mapNsecs = qMin(mapNsecs, timer.nsecsElapsed());
+        QCOMPARE(mappedRow, parsedRow);
+        QCOMPARE(snapshot.date(0), days.first().date);
+    }
+
+    QVERIFY2(mapNsecs * 10 < parseNsecs,
+             qPrintable(QString("snapshot %1 us, xml %2 us").arg(mapNsecs / 1000).arg(parseNsecs / 1000)));
+}
+
+// samat ruoat toistuvat: pool ja merkkijono-osa eivät kasva, vain päivätaulukko
+void TestSnapshot::flatAsDishesRepeat() {
+    const QDate first(2025, 1, 6);
+    DishPool monthPool;
+    QVector<MenuEntry> month = generate(first, 28, monthPool);
+    DishPool yearPool;
+    QVector<MenuEntry> year = generate(first, 364, yearPool);
+    QCOMPARE(yearPool.count(), monthPool.count());
+    // tyhjä, seitsemän päivän nimeä ja ruoat
+    QCOMPARE(yearPool.count(), 1 + 7 + DishCount);
+
+    QString monthFile = dir->path() + "/month.menu";
+    QString yearFile = dir->path() + "/year.menu";
+    QVERIFY(MenuSnapshot::write(monthFile, month, monthPool));
+    QVERIFY(MenuSnapshot::write(yearFile, year, yearPool));
+    QCOMPARE(QFileInfo(yearFile).size() - QFileInfo(monthFile).size(), (364 - 28) * DayRecordSize);
+
+    // yksi kopio jokaisesta tekstistä: koko vuosi mahtuu kymmeneen kilotavuun
+    QVERIFY2(QFileInfo(yearFile).size() < 10 * 1024,
+             qPrintable(QString("%1 bytes").arg(QFileInfo(yearFile).size())));
+}
+
+QTEST_GUILESS_MAIN(TestSnapshot)
+
+#include "tst_snapshot.moc"
@@ -0,0 +1,9 @@
+TARGET = tst_streaming
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+include(../calendar.pri)
+include(../feedserver.pri)
+
+SOURCES += tst_streaming.cpp
@@ -0,0 +1,100 @@
+#include <QtTest>
+#include <QDir>
+#include <QStandardPaths>
+#include "qfoodcalendar.h"
+#include "feedserver.h"
+
+// food.xml trickles in a kilobyte at a time; rows have to show up while
+// the download is still going, in date order, and end up complete.
+class TestStreaming : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void countChanged();
+
+private slots:
+    void initTestCase();
+    void init();
+    void rowsWhileDownloading();
+    void dayFilterWhileDownloading();
+
+private:
+    FeedServer server;
+    QFoodCalendar *calendar;
+    QDate monday;
+    QByteArray xml;
+    qint64 firstRowBytes;
+};
+
+void TestStreaming::countChanged() {
+    if (firstRowBytes < 0 && calendar->rowCount() > 0)
+        firstRowBytes = server.getBytesSent();
+}
+
+void TestStreaming::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(server.listen());
+
+    QDate today = QDate::currentDate();
+    monday = today.addDays(1 - today.dayOfWeek());
+    // noin 60 kt, 1 kt / 20 ms
+    xml = FeedServer::menu(monday, 7, "a", 2000);
+    server.setDocument("/food.xml", xml);
+    server.setThrottle(1024, 20);
+}
+
+// joka testi aloittaa ilman välimuistia ja arkistoa
+void TestStreaming::init() {
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).removeRecursively();
+    QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).removeRecursively();
+    server.resetCounters();
+    firstRowBytes = -1;
+}
+
+void TestStreaming::rowsWhileDownloading() {
+    QFoodCalendar model;
+    calendar = &model;
+    connect(&model, SIGNAL(countChanged()), this, SLOT(countChanged()));
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    model.setSource(server.url("/food.xml"));
+    QCOMPARE(int(model.getStatus()), int(QFoodCalendar::Loading));
+    QTRY_COMPARE_WITH_TIMEOUT(int(model.getStatus()), int(QFoodCalendar::Ready), 10000);
+
+    QCOMPARE(server.getBytesSent(), qint64(xml.size()));
+    QVERIFY(firstRowBytes > 0);
+    QVERIFY(firstRowBytes < xml.size());
+    QVERIFY(inserted.count() > 1);
+
+    QCOMPARE(model.rowCount(), 7);
+    for (int row = 0; row < 7; ++row) {
+        QModelIndex index = model.index(row);
+        QCOMPARE(model.data(index, QFoodCalendar::DateRole).toDate(), monday.addDays(row));
+        QVERIFY(model.data(index, QFoodCalendar::LunchRole).toString().startsWith(QString("a lunch %1 x").arg(row + 1)));
+    }
+}
+
+void TestStreaming::dayFilterWhileDownloading() {
+    QFoodCalendar model;
+    calendar = &model;
+    connect(&model, SIGNAL(countChanged()), this, SLOT(countChanged()));
+    model.setDay(3);
+
+    model.setSource(server.url("/food.xml"));
+    QTRY_VERIFY_WITH_TIMEOUT(model.rowCount() == 1, 10000);
+    QVERIFY(firstRowBytes < xml.size());
+    QTRY_COMPARE_WITH_TIMEOUT(int(model.getStatus()), int(QFoodCalendar::Ready), 10000);
+
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.data(model.index(0), QFoodCalendar::DateRole).toDate(), monday.addDays(2));
+
+    // koko viikko on jo ladattu, päivän vaihto ei hae mitään
+    model.setDay(0);
+    QCOMPARE(model.rowCount(), 7);
+    QCOMPARE(server.getRequests(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestStreaming)
+
+#include "tst_streaming.moc"
@@ -0,0 +1,7 @@
+# Common settings for every test case under tests/.
+QT = core testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+SRC = $$PWD/../src
+INCLUDEPATH += $$SRC
@@ -0,0 +1,27 @@
+# QtTest cases, built separately from the app like tjd:
+#   qmake tests/tests.pro && make && make check
+# Nothing here links QtGui, so no platform plugin is needed on the
+# build host; the network and D-Bus tests bring their own stand-ins.
+TEMPLATE = subdirs
+
+SUBDIRS += visibility \
+    tjd \
+    kiosk \
+    streaming \
+    revalidation \
+    feeds \
+    wakeups \
+    reminders \
+    appstate \
+    mealconfig \
+    roster \
+    dishindex \
+    archive \
+    snapshot \
+    leaderboard \
+    plural
+
+OTHER_FILES += tests.pri \
+    tj.pri \
+    calendar.pri \
+    feedserver.pri
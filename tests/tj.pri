@@ -0,0 +1,15 @@
+# TjCalculatorBackend and what it needs.
+SOURCES += $$SRC/tjcalculatorbackend.cpp \
+    $$SRC/tjcalculatorworker.cpp \
+    $$SRC/pluralformatter.cpp \
+    $$SRC/wakeupscheduler.cpp \
+    $$SRC/qtimespan.cpp \
+    $$SRC/qtimespanvalue.cpp
+
+HEADERS += $$SRC/tjcalculatorbackend.h \
+    $$SRC/tjcalculatorworker.h \
+    $$SRC/pluralformatter.h \
+    $$SRC/wakeupscheduler.h \
+    $$SRC/tjsnapshot.h \
+    $$SRC/qtimespan.h \
+    $$SRC/qtimespanvalue.h
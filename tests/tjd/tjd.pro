@@ -0,0 +1,12 @@
+TARGET = tst_tjd
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+
+QT += dbus
+
+SOURCES += tst_tjd.cpp \
+    $$SRC/tjdbusadaptor.cpp
+
+HEADERS += $$SRC/tjdbusadaptor.h
@@ -0,0 +1,125 @@
+#include <QtTest>
+#include <QProcess>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusVariant>
+#include "tjcalculatorbackend.h"
+#include "tjdbusadaptor.h"
+
+// Runs the tjd object on a private dbus-daemon, so the user's session bus
+// is never touched, and reads it back through a second connection like
+// any other client would.
+class TestTjd : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void tjChanged(const QString &days, const QString &months, const QString &weeks, double done);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void properties();
+    void refreshEmitsChanged();
+
+private:
+    QDBusMessage call(const QString &interface, const QString &method, const QVariantList &arguments = QVariantList());
+    QVariant property(const QString &name);
+
+    QProcess daemon;
+    TjCalculatorBackend *backend;
+    int changes;
+    QStringList lastTexts;
+    double lastDone;
+};
+
+void TestTjd::tjChanged(const QString &days, const QString &months, const QString &weeks, double done) {
+    ++changes;
+    lastTexts = QStringList() << days << months << weeks;
+    lastDone = done;
+}
+
+void TestTjd::initTestCase() {
+    backend = 0;
+    changes = 0;
+    lastDone = 0;
+
+    daemon.start("dbus-daemon", QStringList() << "--session" << "--nofork" << "--print-address");
+    if (!daemon.waitForStarted())
+        QSKIP("dbus-daemon is not installed");
+    QVERIFY(daemon.waitForReadyRead(5000));
+    QString address = QString::fromLatin1(daemon.readLine()).trimmed();
+    QVERIFY(!address.isEmpty());
+
+    QDBusConnection service = QDBusConnection::connectToBus(address, "tjd");
+    QDBusConnection client = QDBusConnection::connectToBus(address, "client");
+    QVERIFY(service.isConnected());
+    QVERIFY(client.isConnected());
+
+    // sama kuin tjd.cpp:ssä, vain väylä on eri
+    backend = new TjCalculatorBackend;
+    new TjDBusAdaptor(backend);
+    QVERIFY(service.registerObject(TJ_DBUS_PATH, backend));
+    QVERIFY(service.registerService(TJ_DBUS_SERVICE));
+
+    QVERIFY(client.connect(TJ_DBUS_SERVICE, TJ_DBUS_PATH, TJ_DBUS_SERVICE, "Changed",
+                           this, SLOT(tjChanged(QString,QString,QString,double))));
+
+    // ensimmäinen laskenta on jo matkalla
+    QSignalSpy calculated(backend, SIGNAL(calculated()));
+    QVERIFY(calculated.wait());
+}
+
+void TestTjd::cleanupTestCase() {
+    QDBusConnection::disconnectFromBus("client");
+    QDBusConnection::disconnectFromBus("tjd");
+    delete backend;
+    if (daemon.state() != QProcess::NotRunning) {
+        daemon.terminate();
+        daemon.waitForFinished();
+    }
+}
+
+// kutsut ovat asynkronisia, koska palvelu vastaa samasta säikeestä
+QDBusMessage TestTjd::call(const QString &interface, const QString &method, const QVariantList &arguments) {
+    QDBusMessage message = QDBusMessage::createMethodCall(TJ_DBUS_SERVICE, TJ_DBUS_PATH, interface, method);
+    message.setArguments(arguments);
+    QDBusPendingCall pending = QDBusConnection("client").asyncCall(message);
+    QDBusPendingCallWatcher watcher(pending);
+    QSignalSpy finished(&watcher, SIGNAL(finished(QDBusPendingCallWatcher*)));
+    if (!pending.isFinished())
+        finished.wait(5000);
+    return pending.reply();
+}
+
+QVariant TestTjd::property(const QString &name) {
+    QDBusMessage reply = call("org.freedesktop.DBus.Properties", "Get",
+                              QVariantList() << QString(TJ_DBUS_SERVICE) << name);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty())
+        return QVariant();
+    return qvariant_cast<QDBusVariant>(reply.arguments().first()).variant();
+}
+
+void TestTjd::properties() {
+    QCOMPARE(property("TjInDays").toString(), backend->getTjInDays());
+    QCOMPARE(property("TjInMonths").toString(), backend->getTjInMonths());
+    QCOMPARE(property("TjInWeeks").toString(), backend->getTjInWeeks());
+    QCOMPARE(property("DaysDone").toDouble(), double(backend->getDaysDone()));
+    QVERIFY(!property("TjInDays").toString().isEmpty());
+}
+
+void TestTjd::refreshEmitsChanged() {
+    int before = changes;
+    QDBusMessage reply = call(TJ_DBUS_SERVICE, "Refresh");
+    QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+
+    QTRY_COMPARE(changes, before + 1);
+    QCOMPARE(lastTexts, QStringList() << backend->getTjInDays() << backend->getTjInMonths() << backend->getTjInWeeks());
+    QCOMPARE(lastDone, double(backend->getDaysDone()));
+}
+
+QTEST_GUILESS_MAIN(TestTjd)
+
+#include "tst_tjd.moc"
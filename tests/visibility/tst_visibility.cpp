@@ -0,0 +1,119 @@
+#include <QtTest>
+#include "visibilitytracker.h"
+#include "wakeupscheduler.h"
+#include "tjcalculatorbackend.h"
+#include "roster.h"
+#include "rosterleaderboard.h"
+
+// Wires the tracker to the backend and the leaderboard the way main()
+// does and counts wakeups and recalculations across hide/show.
+class TestVisibility : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void hiddenHasNoWakeups();
+    void showRefreshesOnce();
+    void coverKeepsVisible();
+    void countsHiddenTime();
+
+private:
+    TjCalculatorBackend *backend;
+    Roster *roster;
+    RosterLeaderboard *leaderboard;
+    VisibilityTracker *tracker;
+};
+
+void TestVisibility::init() {
+    backend = new TjCalculatorBackend;
+    roster = new Roster;
+    leaderboard = new RosterLeaderboard(roster);
+    tracker = new VisibilityTracker;
+    connect(tracker, SIGNAL(visibleChanged(bool)), backend, SLOT(setActive(bool)));
+    connect(tracker, SIGNAL(visibleChanged(bool)), leaderboard, SLOT(setActive(bool)));
+
+    // konstruktori laskee kerran, odotetaan se pois alta
+    QSignalSpy calculated(backend, SIGNAL(calculated()));
+    QVERIFY(calculated.wait());
+    // päivänvaihto ja keskiyö
+    QCOMPARE(WakeupScheduler::instance()->getPending(), 2);
+}
+
+void TestVisibility::cleanup() {
+    delete tracker;
+    delete leaderboard;
+    delete roster;
+    delete backend;
+}
+
+void TestVisibility::hiddenHasNoWakeups() {
+    QSignalSpy calculated(backend, SIGNAL(calculated()));
+    int wakeups = WakeupScheduler::instance()->getWakeups();
+
+    tracker->setApplicationActive(false);
+    QVERIFY(!tracker->isVisible());
+    QCOMPARE(WakeupScheduler::instance()->getPending(), 0);
+
+    // ajastin ei ole viritettynä, eikä kukaan laske mitään
+    QTest::qWait(300);
+    QCOMPARE(WakeupScheduler::instance()->getWakeups(), wakeups);
+    QCOMPARE(calculated.count(), 0);
+}
+
+void TestVisibility::showRefreshesOnce() {
+    tracker->setApplicationActive(false);
+    QSignalSpy calculated(backend, SIGNAL(calculated()));
+    QSignalSpy today(leaderboard, SIGNAL(todayChanged()));
+
+    tracker->setApplicationActive(true);
+    QVERIFY(calculated.wait());
+    QTest::qWait(300);
+    QCOMPARE(calculated.count(), 1);
+    // sama päivä, nextDay() ajettiin mutta mikään ei muuttunut
+    QCOMPARE(today.count(), 0);
+    QCOMPARE(WakeupScheduler::instance()->getPending(), 2);
+}
+
+void TestVisibility::coverKeepsVisible() {
+    QSignalSpy visible(tracker, SIGNAL(visibleChanged(bool)));
+    QSignalSpy calculated(backend, SIGNAL(calculated()));
+
+    // ikkuna taustalle kannen ollessa näkyvissä ei piilota mitään
+    tracker->setCoverActive(true);
+    tracker->setApplicationActive(false);
+    QCOMPARE(visible.count(), 0);
+    QCOMPARE(WakeupScheduler::instance()->getPending(), 2);
+
+    tracker->setCoverActive(false);
+    QCOMPARE(visible.count(), 1);
+    QCOMPARE(WakeupScheduler::instance()->getPending(), 0);
+
+    // kansi ja ikkuna takaisin peräkkäin, vain ensimmäinen laskee
+    tracker->setCoverActive(true);
+    tracker->setApplicationActive(true);
+    QCOMPARE(visible.count(), 2);
+    QVERIFY(calculated.wait());
+    QTest::qWait(300);
+    QCOMPARE(calculated.count(), 1);
+}
+
+void TestVisibility::countsHiddenTime() {
+    QCOMPARE(tracker->getHiddenMSecs(), Q_INT64_C(0));
+    tracker->setApplicationActive(false);
+    QTest::qWait(200);
+    tracker->setApplicationActive(true);
+    qint64 hidden = tracker->getHiddenMSecs();
+    QVERIFY(hidden >= 150);
+    QVERIFY(tracker->getHiddenCpuMSecs() >= 0);
+    QVERIFY(tracker->getHiddenCpuMSecs() <= hidden + 50);
+
+    // näkyvissä aika ei kerry
+    QTest::qWait(100);
+    QCOMPARE(tracker->getHiddenMSecs(), hidden);
+}
+
+QTEST_GUILESS_MAIN(TestVisibility)
+
+#include "tst_visibility.moc"
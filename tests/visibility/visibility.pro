@@ -0,0 +1,16 @@
+TARGET = tst_visibility
+TEMPLATE = app
+
+include(../tests.pri)
+include(../tj.pri)
+
+SOURCES += tst_visibility.cpp \
+    $$SRC/visibilitytracker.cpp \
+    $$SRC/roster.cpp \
+    $$SRC/orderstatistictree.cpp \
+    $$SRC/rosterleaderboard.cpp
+
+HEADERS += $$SRC/visibilitytracker.h \
+    $$SRC/roster.h \
+    $$SRC/orderstatistictree.h \
+    $$SRC/rosterleaderboard.h
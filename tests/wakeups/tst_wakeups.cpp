@@ -0,0 +1,168 @@
+#include <QtTest>
+#include "wakeupscheduler.h"
+
+// simuloitu seinäkello, ajastin ajetaan käsin sen mukaan
+static qint64 fakeNow = 0;
+
+static qint64 fakeClock() {
+    return fakeNow;
+}
+
+// Wakes up at the same times every day, like the meal, countdown and
+// leaderboard clients of the app, and reschedules itself when fired.
+class DailyClient : public QObject
+{
+    Q_OBJECT
+public:
+    DailyClient(WakeupScheduler *scheduler, const QList<QTime> &times) :
+        scheduler(scheduler), times(times)
+    {
+        scheduleNext();
+    }
+
+    QList<qint64> deadlines;
+    QList<qint64> fired;
+
+public slots:
+    void fire() {
+        fired << fakeNow;
+        scheduleNext();
+    }
+
+private:
+    void scheduleNext() {
+        QDate today = QDateTime::fromMSecsSinceEpoch(fakeNow).date();
+        qint64 next = -1;
+        for (int day = 0; day < 2 && next < 0; ++day) {
+            foreach (const QTime &time, times) {
+                qint64 at = QDateTime(today.addDays(day), time).toMSecsSinceEpoch();
+                if (at > fakeNow && (next < 0 || at < next))
+                    next = at;
+            }
+        }
+        deadlines << next;
+        scheduler->schedule(this, "fire", QDateTime::fromMSecsSinceEpoch(next));
+    }
+
+    WakeupScheduler *scheduler;
+    QList<QTime> times;
+};
+
+// Coalescing and the per-day wakeup counts, on a simulated clock. The
+// real timer never gets to fire; the test jumps the clock to where the
+// scheduler armed it and runs the wakeup itself.
+class TestWakeups : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void coalescesWithinTolerance();
+    void separateBeyondTolerance();
+    void wakeupsPerDay();
+    void statsKeepAWeek();
+
+private:
+    void runUntil(const QDateTime &end);
+
+    WakeupScheduler *scheduler;
+};
+
+void TestWakeups::init() {
+    // tammikuussa ei kesäajan vaihtoa
+    fakeNow = QDateTime(QDate(2026, 1, 12), QTime(0, 30)).toMSecsSinceEpoch();
+    scheduler = new WakeupScheduler;
+    scheduler->setClock(fakeClock);
+}
+
+void TestWakeups::cleanup() {
+    delete scheduler;
+}
+
+void TestWakeups::runUntil(const QDateTime &end) {
+    qint64 last = end.toMSecsSinceEpoch();
+    for (;;) {
+        qint64 next = scheduler->getNextWakeup();
+        // loppuhetki ei kuulu enää jaksoon
+        if (next < 0 || next >= last)
+            break;
+        fakeNow = next;
+        QMetaObject::invokeMethod(scheduler, "wakeup");
+    }
+    fakeNow = last;
+}
+
+void TestWakeups::coalescesWithinTolerance() {
+    DailyClient countdown(scheduler, QList<QTime>() << QTime(15, 0, 0));
+    DailyClient reminder(scheduler, QList<QTime>() << QTime(15, 0, 3));
+    QDate day(2026, 1, 12);
+
+    // herätetään vasta myöhemmän kohdalla, kumpikaan ei laukea etuajassa
+    QCOMPARE(scheduler->getNextWakeup(), QDateTime(day, QTime(15, 0, 3)).toMSecsSinceEpoch());
+    runUntil(QDateTime(day, QTime(16, 0)));
+    QCOMPARE(countdown.fired.count(), 1);
+    QCOMPARE(reminder.fired.count(), 1);
+    QVERIFY(countdown.fired.first() >= countdown.deadlines.first());
+    QVERIFY(reminder.fired.first() >= reminder.deadlines.first());
+    QCOMPARE(countdown.fired.first(), reminder.fired.first());
+    QCOMPARE(scheduler->getWakeups(), 1);
+}
+
+void TestWakeups::separateBeyondTolerance() {
+    DailyClient countdown(scheduler, QList<QTime>() << QTime(15, 0, 0));
+    DailyClient reminder(scheduler, QList<QTime>() << QTime(15, 0, 8));
+    QDate day(2026, 1, 12);
+
+    QCOMPARE(scheduler->getNextWakeup(), QDateTime(day, QTime(15, 0, 0)).toMSecsSinceEpoch());
+    runUntil(QDateTime(day, QTime(16, 0)));
+    QCOMPARE(scheduler->getWakeups(), 2);
+    QCOMPARE(countdown.fired.first(), countdown.deadlines.first());
+    QCOMPARE(reminder.fired.first(), reminder.deadlines.first());
+}
+
+// neljä ateriaa, keskiyö ja kaksi määräaikaa kolmen sekunnin päässä
+// toisistaan: seitsemän määräaikaa, kuusi herätystä päivässä
+void TestWakeups::wakeupsPerDay() {
+    DailyClient meals(scheduler, QList<QTime>() << QTime(7, 0) << QTime(11, 0) << QTime(16, 0) << QTime(19, 0));
+    DailyClient midnight(scheduler, QList<QTime>() << QTime(0, 0));
+    DailyClient countdown(scheduler, QList<QTime>() << QTime(15, 0, 0));
+    DailyClient reminder(scheduler, QList<QTime>() << QTime(15, 0, 3));
+
+    QDate first(2026, 1, 12);
+    runUntil(QDateTime(first.addDays(3)));
+
+    // ensimmäinen päivä alkoi 00:30, keskiyö jäi väliin
+    WakeupScheduler::DayStats stats = scheduler->getDayStats(first);
+    QCOMPARE(stats.wakeups, 5);
+    QCOMPARE(stats.deadlines, 6);
+    for (int day = 1; day < 3; ++day) {
+        stats = scheduler->getDayStats(first.addDays(day));
+        QCOMPARE(stats.wakeups, 6);
+        QCOMPARE(stats.deadlines, 7);
+    }
+    QCOMPARE(scheduler->getDayStats(first.addDays(3)).wakeups, 0);
+
+    // kukaan ei herännyt ennen määräaikaansa
+    QList<DailyClient *> clients;
+    clients << &meals << &midnight << &countdown << &reminder;
+    foreach (DailyClient *client, clients) {
+        for (int i = 0; i < client->fired.count(); ++i)
+            QVERIFY(client->fired.at(i) >= client->deadlines.at(i));
+    }
+}
+
+void TestWakeups::statsKeepAWeek() {
+    DailyClient midnight(scheduler, QList<QTime>() << QTime(0, 0));
+    QDate first(2026, 1, 12);
+    runUntil(QDateTime(first.addDays(10), QTime(12, 0)));
+
+    QCOMPARE(scheduler->getWakeups(), 10);
+    QCOMPARE(scheduler->getDayStats(first.addDays(10)).wakeups, 1);
+    QCOMPARE(scheduler->getDayStats(first.addDays(4)).wakeups, 1);
+    QCOMPARE(scheduler->getDayStats(first.addDays(3)).wakeups, 0);
+}
+
+QTEST_GUILESS_MAIN(TestWakeups)
+
+#include "tst_wakeups.moc"
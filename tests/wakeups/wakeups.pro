@@ -0,0 +1,9 @@
+TARGET = tst_wakeups
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += tst_wakeups.cpp \
+    $$SRC/wakeupscheduler.cpp
+
+HEADERS += $$SRC/wakeupscheduler.h
@@ -0,0 +1,36 @@
+# Headless TJ countdown daemon, exposes TjCalculatorBackend over D-Bus.
+TARGET = SotkuMuija-tjd
+TEMPLATE = app
+
+QT = core dbus
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../src
+
+SOURCES += ../src/tjd.cpp \
+    ../src/tjdbusadaptor.cpp \
+    ../src/tjcalculatorbackend.cpp \
+    ../src/tjcalculatorworker.cpp \
+    ../src/pluralformatter.cpp \
+    ../src/wakeupscheduler.cpp \
+    ../src/qtimespan.cpp \
+    ../src/qtimespanvalue.cpp
+
+HEADERS += ../src/tjdbusadaptor.h \
+    ../src/tjcalculatorbackend.h \
+    ../src/tjcalculatorworker.h \
+    ../src/pluralformatter.h \
+    ../src/wakeupscheduler.h \
+    ../src/tjsnapshot.h \
+    ../src/qtimespan.h \
+    ../src/qtimespanvalue.h
+
+OTHER_FILES += fi.sotkumuija.Tj.service
+
+target.path = /usr/bin
+
+service.files = fi.sotkumuija.Tj.service
+service.path = /usr/share/dbus-1/services
+
+INSTALLS += target service